@@ -0,0 +1,328 @@
+#include <algorithm>
+
+#include "aabb_tree.h"
+
+double AABBTree::AABB::perimeter() const {
+    return 2.0 * ((x1 - x0) + (y1 - y0));
+}
+
+bool AABBTree::AABB::contains(const AABB& o) const {
+    return x0 <= o.x0 && y0 <= o.y0 && o.x1 <= x1 && o.y1 <= y1;
+}
+
+bool AABBTree::AABB::overlaps(const AABB& o) const {
+    return x0 <= o.x1 && o.x0 <= x1 && y0 <= o.y1 && o.y0 <= y1;
+}
+
+AABBTree::AABB AABBTree::AABB::combine(const AABB& a, const AABB& b) {
+    return {std::min(a.x0, b.x0), std::min(a.y0, b.y0), std::max(a.x1, b.x1), std::max(a.y1, b.y1)};
+}
+
+// bounding box of a circle extended by margin on each side
+AABBTree::AABB AABBTree::AABB::of(const CollisionCircle& c, double margin) {
+    double r = c.r + margin;
+    return {c.x - r, c.y - r, c.x + r, c.y + r};
+}
+
+AABBTree::AABBTree() {
+    nodes.reserve(INITIAL_CAP);
+}
+
+// stars are only ever added to the back of the stars vector, so the new leaf belongs to star leaves.size()
+void AABBTree::add(const CollisionCircle& c) {
+    int leaf = allocateNode();
+
+    nodes[leaf].box    = AABB::of(c, FAT_MARGIN);
+    nodes[leaf].height = 0;
+    nodes[leaf].star   = leaves.size();
+
+    leaves.push_back(leaf);
+    insertLeaf(leaf);
+}
+
+// stars are only ever removed from the back of the stars vector
+void AABBTree::removeLast() {
+    if (leaves.empty()) return;
+
+    int leaf = leaves.back();
+    leaves.pop_back();
+
+    removeLeaf(leaf);
+    freeNode(leaf);
+}
+
+// re-inserts the stars that have left their fat boxes since the last update
+void AABBTree::update(const std::vector<CollisionCircle>& circles) {
+    for (unsigned i = 0; i < leaves.size() && i < circles.size(); i++) {
+        int leaf = leaves[i];
+
+        if (nodes[leaf].box.contains(AABB::of(circles[i], 0.0))) continue;
+
+        removeLeaf(leaf);
+        nodes[leaf].box = AABB::of(circles[i], FAT_MARGIN);
+        insertLeaf(leaf);
+    }
+}
+
+void AABBTree::findCandidates(const std::vector<CollisionCircle>& circles, CollisionCandidates& out) {
+    out.clear();
+
+    for (unsigned i = 0; i < circles.size(); i++) {
+        const CollisionCircle& a = circles[i];
+        AABB box                 = AABB::of(a, 0.0);
+
+        scratch.clear();
+        stack.clear();
+
+        if (root != NULL_NODE) stack.push_back(root);
+
+        while (!stack.empty()) {
+            const Node& n = nodes[stack.back()];
+            stack.pop_back();
+
+            if (!n.box.overlaps(box)) continue;
+
+            if (n.isLeaf()) {
+                // the fat box of the leaf overlapping is not enough, the actual bounding boxes must overlap too
+                if (n.star > i && n.star < circles.size() && AABB::of(circles[n.star], 0.0).overlaps(box)) scratch.push_back(n.star);
+            } else {
+                stack.push_back(n.child1);
+                stack.push_back(n.child2);
+            }
+        }
+
+        std::sort(scratch.begin(), scratch.end());
+
+        for (unsigned j : scratch) {
+            out.push(j);
+        }
+        out.next();
+    }
+}
+
+int AABBTree::allocateNode() {
+    if (freeList == NULL_NODE) {
+        nodes.push_back({});
+        nodes.back().parent = NULL_NODE;
+        freeList            = nodes.size() - 1;
+    }
+
+    int node = freeList;
+    freeList = nodes[node].parent;
+
+    nodes[node].parent = NULL_NODE;
+    nodes[node].child1 = NULL_NODE;
+    nodes[node].child2 = NULL_NODE;
+    nodes[node].height = 0;
+
+    return node;
+}
+
+void AABBTree::freeNode(int node) {
+    nodes[node].parent = freeList;
+    nodes[node].height = -1;
+    freeList           = node;
+}
+
+void AABBTree::insertLeaf(int leaf) {
+    if (root == NULL_NODE) {
+        root               = leaf;
+        nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // find the best sibling: descend while it is cheaper to push the leaf further down than to pair it with the current node
+
+    AABB leafBox = nodes[leaf].box;
+    int index    = root;
+
+    while (!nodes[index].isLeaf()) {
+        const Node& n = nodes[index];
+
+        double area         = n.box.perimeter();
+        double combinedArea = AABB::combine(n.box, leafBox).perimeter();
+
+        // cost of creating a new parent for this node and the new leaf
+        double cost = 2.0 * combinedArea;
+        // minimum cost of pushing the leaf further down the tree
+        double inheritance = 2.0 * (combinedArea - area);
+
+        auto descendCost = [&](int child) {
+            const Node& c    = nodes[child];
+            double childCost = AABB::combine(leafBox, c.box).perimeter() + inheritance;
+            return c.isLeaf() ? childCost : childCost - c.box.perimeter();
+        };
+
+        double cost1 = descendCost(n.child1);
+        double cost2 = descendCost(n.child2);
+
+        if (cost < cost1 && cost < cost2) break;
+
+        index = cost1 < cost2 ? n.child1 : n.child2;
+    }
+
+    int sibling   = index;
+    int oldParent = nodes[sibling].parent;
+    int newParent = allocateNode();
+
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].box    = AABB::combine(leafBox, nodes[sibling].box);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent    = newParent;
+
+    if (oldParent != NULL_NODE) {
+        if (nodes[oldParent].child1 == sibling) nodes[oldParent].child1 = newParent;
+        else nodes[oldParent].child2 = newParent;
+    } else {
+        root = newParent;
+    }
+
+    refit(nodes[leaf].parent);
+}
+
+void AABBTree::removeLeaf(int leaf) {
+    if (leaf == root) {
+        root = NULL_NODE;
+        return;
+    }
+
+    int parent      = nodes[leaf].parent;
+    int grandParent = nodes[parent].parent;
+    int sibling     = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grandParent != NULL_NODE) {
+        if (nodes[grandParent].child1 == parent) nodes[grandParent].child1 = sibling;
+        else nodes[grandParent].child2 = sibling;
+
+        nodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        refit(grandParent);
+    } else {
+        root                  = sibling;
+        nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+    }
+}
+
+// walks from index up to the root, rebalancing and recomputing the heights and boxes of every node on the way
+void AABBTree::refit(int index) {
+    while (index != NULL_NODE) {
+        index = balance(index);
+
+        Node& n = nodes[index];
+
+        n.height = 1 + std::max(nodes[n.child1].height, nodes[n.child2].height);
+        n.box    = AABB::combine(nodes[n.child1].box, nodes[n.child2].box);
+
+        index = n.parent;
+    }
+}
+
+/*
+Performs a left or right rotation if node A is imbalanced and returns the new root of the subtree.
+
+         A
+       /   \
+      B     C
+     / \   / \
+    D   E F   G
+
+If C is more than one level taller than B, C is rotated up and A becomes a child of C (and vice versa for B).
+*/
+int AABBTree::balance(int iA) {
+    Node& A = nodes[iA];
+
+    if (A.isLeaf() || A.height < 2) return iA;
+
+    int iB  = A.child1;
+    int iC  = A.child2;
+    Node& B = nodes[iB];
+    Node& C = nodes[iC];
+
+    int diff = C.height - B.height;
+
+    // rotate C up
+    if (diff > 1) {
+        int iF  = C.child1;
+        int iG  = C.child2;
+        Node& F = nodes[iF];
+        Node& G = nodes[iG];
+
+        C.child1 = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+
+        if (C.parent != NULL_NODE) {
+            if (nodes[C.parent].child1 == iA) nodes[C.parent].child1 = iC;
+            else nodes[C.parent].child2 = iC;
+        } else {
+            root = iC;
+        }
+
+        if (F.height > G.height) {
+            C.child2 = iF;
+            A.child2 = iG;
+            G.parent = iA;
+            A.box    = AABB::combine(B.box, G.box);
+            C.box    = AABB::combine(A.box, F.box);
+            A.height = 1 + std::max(B.height, G.height);
+            C.height = 1 + std::max(A.height, F.height);
+        } else {
+            C.child2 = iG;
+            A.child2 = iF;
+            F.parent = iA;
+            A.box    = AABB::combine(B.box, F.box);
+            C.box    = AABB::combine(A.box, G.box);
+            A.height = 1 + std::max(B.height, F.height);
+            C.height = 1 + std::max(A.height, G.height);
+        }
+
+        return iC;
+    }
+
+    // rotate B up
+    if (diff < -1) {
+        int iD  = B.child1;
+        int iE  = B.child2;
+        Node& D = nodes[iD];
+        Node& E = nodes[iE];
+
+        B.child1 = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+
+        if (B.parent != NULL_NODE) {
+            if (nodes[B.parent].child1 == iA) nodes[B.parent].child1 = iB;
+            else nodes[B.parent].child2 = iB;
+        } else {
+            root = iB;
+        }
+
+        if (D.height > E.height) {
+            B.child2 = iD;
+            A.child1 = iE;
+            E.parent = iA;
+            A.box    = AABB::combine(C.box, E.box);
+            B.box    = AABB::combine(A.box, D.box);
+            A.height = 1 + std::max(C.height, E.height);
+            B.height = 1 + std::max(A.height, D.height);
+        } else {
+            B.child2 = iE;
+            A.child1 = iD;
+            D.parent = iA;
+            A.box    = AABB::combine(C.box, D.box);
+            B.box    = AABB::combine(A.box, E.box);
+            A.height = 1 + std::max(C.height, D.height);
+            B.height = 1 + std::max(A.height, E.height);
+        }
+
+        return iB;
+    }
+
+    return iA;
+}
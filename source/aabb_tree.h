@@ -0,0 +1,82 @@
+#ifndef AABB_TREE_H_GUARD
+#define AABB_TREE_H_GUARD
+
+#include <vector>
+
+#include "broadphase.h"
+
+/*
+Dynamic AABB tree broadphase (bounding volume hierarchy).
+
+Every star is a leaf whose axis-aligned bounding box is "fattened" by FAT_MARGIN on each side.
+As long as the actual bounding box of a star stays within its fat box, its leaf does not have to be touched, so most frames need no tree updates at all.
+When a star escapes its fat box, its leaf is removed and re-inserted with a new fat box.
+
+Unlike a uniform grid, the tree does not depend on a cell size, so it handles scenes that mix very small and very large stars: queries are logarithmic for every star size.
+
+Leaves are inserted next to the sibling that results in the smallest increase in total perimeter, and the tree is kept balanced with AVL-style rotations.
+*/
+struct AABBTree {
+    static constexpr int NULL_NODE        = -1;
+    static constexpr double FAT_MARGIN    = 8.0; // pixels
+    static constexpr unsigned INITIAL_CAP = 64;
+
+    struct AABB {
+        double x0;
+        double y0;
+        double x1;
+        double y1;
+
+        double perimeter() const;
+        bool contains(const AABB&) const;
+        bool overlaps(const AABB&) const;
+
+        static AABB combine(const AABB&, const AABB&);
+        static AABB of(const CollisionCircle&, double);
+    };
+
+    struct Node {
+        AABB box;
+
+        // doubles as the next free node while the node is in the free list
+        int parent;
+        int child1;
+        int child2;
+        // leaf == 0, free node == -1
+        int height;
+
+        unsigned star;
+
+        bool isLeaf() const {
+            return child1 == NULL_NODE;
+        }
+    };
+
+    std::vector<Node> nodes;
+    int root     = NULL_NODE;
+    int freeList = NULL_NODE;
+
+    // leaf node of each star, indexed by star index
+    std::vector<int> leaves;
+
+    // query scratch space
+    std::vector<int> stack;
+    std::vector<unsigned> scratch;
+
+    AABBTree();
+
+    void add(const CollisionCircle&);
+    void removeLast();
+
+    void update(const std::vector<CollisionCircle>&);
+    void findCandidates(const std::vector<CollisionCircle>&, CollisionCandidates&);
+
+    int allocateNode();
+    void freeNode(int);
+    void insertLeaf(int);
+    void removeLeaf(int);
+    int balance(int);
+    void refit(int);
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef ALIGNED_ALLOCATOR_H_GUARD
+#define ALIGNED_ALLOCATOR_H_GUARD
+
+#include <cstddef>
+#include <new>
+
+// Allocator for std::vector that aligns the start of the storage to Alignment bytes (e.g. a cache line).
+template <typename T, std::size_t Alignment>
+struct AlignedAllocator {
+    using value_type = T;
+
+    // required because of the non-type template parameter
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const {
+        return true;
+    }
+};
+
+#endif
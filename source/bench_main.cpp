@@ -0,0 +1,344 @@
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "config.h"
+#include "elastic_collision_response.h"
+#include "integration.h"
+#include "overlap_correction.h"
+#include "rng.h"
+#include "software_rasterizer.h"
+#include "star.h"
+#include "star_meshes.h"
+#include "star_shape.h"
+#include "star_system.h"
+
+/*
+Microbenchmarks of the physics and geometry hot paths (stars_bench): pairwise collision, overlap correction, collision response, the update pass for every combination of physics features, star geometry, mesh lookup, the hue palette, and RNG draws.
+
+Each benchmark runs one function in isolation on fixed inputs (the RNG is seeded), so changes to it show up without the noise of a full simulation step (see sim_main.cpp for that).
+Progress goes to stderr and the results (see benchmark.h) go to stdout as JSON, unless --out is given.
+*/
+
+static const char USAGE[] = "usage: stars_bench [--repetitions N] [--min-time SECONDS] [--filter SUBSTRING] [--out FILE]\n";
+
+static constexpr double WORLD_W = 1920.0;
+static constexpr double WORLD_H = 1080.0;
+
+static constexpr unsigned UPDATE_STARS = 1024;
+static constexpr unsigned HUES         = 1024;
+
+static constexpr int SHAPE_TIPS[] = {3, 4, 6, 12, 25, 50, 100};
+
+template <typename T>
+bool parse(const char* first, const char* last, T& value) {
+    std::from_chars_result r = std::from_chars(first, last, value);
+    return r.ec == std::errc() && r.ptr == last;
+}
+
+bool parseArguments(int argc, char** argv, BenchmarkRunner& runner, std::string& out) {
+    bool valid = true;
+
+    for (int i = 1; i < argc && valid; i++) {
+        const char* arg   = argv[i];
+        const char* value = i + 1 < argc ? argv[++i] : nullptr;
+        const char* end   = value ? value + strlen(value) : nullptr;
+
+        if (!value) {
+            valid = false;
+        } else if (strcmp(arg, "--repetitions") == 0) {
+            valid = parse(value, end, runner.repetitions) && runner.repetitions > 0;
+        } else if (strcmp(arg, "--min-time") == 0) {
+            valid = parse(value, end, runner.minTime) && runner.minTime > 0.0;
+        } else if (strcmp(arg, "--filter") == 0) {
+            runner.filter = value;
+        } else if (strcmp(arg, "--out") == 0) {
+            out = value;
+        } else {
+            valid = false;
+        }
+    }
+
+    if (!valid) std::cerr << USAGE;
+
+    return valid;
+}
+
+// name of a feature bitmask, e.g. "gravity+max_speed"
+std::string featureName(unsigned features) {
+    static const char* const names[] = {"gravity", "accel", "min_speed", "max_speed"}; // same order as the IntegrationFeature bits
+
+    std::string name;
+
+    for (unsigned f = 0; f < IntegrationFeature::COUNT; f++) {
+        if (features & (1 << f)) {
+            if (!name.empty()) name += '+';
+            name += names[f];
+        }
+    }
+
+    return name.empty() ? "none" : name;
+}
+
+// two stars that either overlap or are far apart; positions and velocities are restored before every call, so each call performs the same work
+void collisionBenchmarks(BenchmarkRunner& runner, const Config& cfg, RNG& rng) {
+    for (bool hit : {true, false}) {
+        StarSystem s;
+        s.add(Star(Enum::Star::GenType::RNG, cfg, rng, WORLD_W, WORLD_H));
+        s.add(Star(Enum::Star::GenType::RNG, cfg, rng, WORLD_W, WORLD_H));
+
+        double distance = hit ? (s.aRadius[0] + s.aRadius[1]) * 0.75 : (s.aRadius[0] + s.aRadius[1]) * 4.0;
+
+        double x[2]    = {WORLD_W / 2.0, WORLD_W / 2.0 + distance * 0.6};
+        double y[2]    = {WORLD_H / 2.0, WORLD_H / 2.0 + distance * 0.8};
+        double xVel[2] = {120.0, -80.0};
+        double yVel[2] = {-40.0, 60.0};
+
+        runner.run(hit ? "StarSystem::collision/hit" : "StarSystem::collision/miss", [&](unsigned n) {
+            for (unsigned i = 0; i < n; i++) {
+                for (unsigned j = 0; j < 2; j++) {
+                    s.x[j]    = x[j];
+                    s.y[j]    = y[j];
+                    s.xVel[j] = xVel[j];
+                    s.yVel[j] = yVel[j];
+                }
+
+                bool collided = s.collision(0, 1);
+                doNotOptimize(collided);
+            }
+        });
+    }
+}
+
+void contactBenchmarks(BenchmarkRunner& runner) {
+    runner.run("overlapCorrection", [](unsigned n) {
+        for (unsigned i = 0; i < n; i++) {
+            double a_x = 100.0, a_y = 100.0;
+            double b_x = 112.0, b_y = 109.0;
+
+            // the inputs are constants; without this, the compiler could compute the result at compile time
+            doNotOptimize(a_x);
+            doNotOptimize(b_x);
+
+            overlapCorrection(a_x, a_y, b_x, b_y, 20.0, 15.0);
+
+            doNotOptimize(a_x);
+            doNotOptimize(a_y);
+            doNotOptimize(b_x);
+            doNotOptimize(b_y);
+        }
+    });
+
+    runner.run("elasticCollisionResponse", [](unsigned n) {
+        for (unsigned i = 0; i < n; i++) {
+            double a_x_vel = 120.0, a_y_vel = -40.0;
+            double b_x_vel = -80.0, b_y_vel = 60.0;
+
+            doNotOptimize(a_x_vel);
+            doNotOptimize(b_x_vel);
+
+            elasticCollisionResponse(100.0, 100.0, 112.0, 109.0, a_x_vel, a_y_vel, b_x_vel, b_y_vel, 3.0, 5.0);
+
+            doNotOptimize(a_x_vel);
+            doNotOptimize(a_y_vel);
+            doNotOptimize(b_x_vel);
+            doNotOptimize(b_y_vel);
+        }
+    });
+}
+
+// one update pass over UPDATE_STARS stars per operation, for the scalar reference and the selected SIMD kernel
+void updateBenchmarks(BenchmarkRunner& runner, const Config& cfg, RNG& rng) {
+    StarSystem s;
+    s.reserve(UPDATE_STARS);
+
+    for (unsigned i = 0; i < UPDATE_STARS; i++) {
+        s.add(Star(Enum::Star::GenType::RNG, cfg, rng, WORLD_W, WORLD_H));
+    }
+
+    IntegrationKernelInfo kernels[] = {{"scalar", integrateScalar}, StarSystem::integration};
+
+    for (const IntegrationKernelInfo& k : kernels) {
+        for (unsigned features = 0; features < IntegrationFeature::COMBINATIONS; features++) {
+            Config c = cfg;
+
+            c.gravity  = features & IntegrationFeature::GRAVITY;
+            c.accel    = features & IntegrationFeature::ACCEL;
+            c.minSpeed = features & IntegrationFeature::MIN_SPEED;
+            c.maxSpeed = features & IntegrationFeature::MAX_SPEED;
+
+            IntegrationParams p = StarSystem::integrationParams(c, 1.0 / c.targetFPS, WORLD_W, WORLD_H);
+
+            IntegrationArrays a = {s.x.data(), s.y.data(), s.xVel.data(), s.yVel.data(), s.ang.data(), s.angVel.data(), s.oRadius.data()};
+
+            runner.run(std::string("StarSystem::update/") + k.name + "/" + featureName(features), [&](unsigned n) {
+                for (unsigned i = 0; i < n; i++) {
+                    k.kernel(p, a, 0, s.size());
+                    doNotOptimize(s.x[0]);
+                }
+            }, s.size());
+        }
+    }
+}
+
+// builds the geometry of one star shape per operation (including the allocation of its vertex and index arrays)
+void shapeBenchmarks(BenchmarkRunner& runner) {
+    for (int tips : SHAPE_TIPS) {
+        StarShape shape(tips, 0.5, 1.0, {Star::Core::FULL, Star::Draw::FILL});
+
+        runner.run("StarShape::fullCore/tips=" + std::to_string(tips), [&](unsigned n) {
+            for (unsigned i = 0; i < n; i++) {
+                shape.fullCore();
+                doNotOptimize(shape.vertices[0]);
+            }
+        });
+
+        runner.run("StarShape::emptyCore/tips=" + std::to_string(tips), [&](unsigned n) {
+            for (unsigned i = 0; i < n; i++) {
+                shape.emptyCore();
+                doNotOptimize(shape.vertices[0]);
+            }
+        });
+    }
+}
+
+// the mesh of one star per operation, acquired and released again: of a class that other stars use already (shared), or of a class whose meshes (and LOD meshes) are built and deleted again (new)
+void meshBenchmarks(BenchmarkRunner& runner, const Config& cfg, RNG& rng) {
+    StarSystem s;
+    s.reserve(UPDATE_STARS);
+
+    StarMeshes shared;
+
+    for (unsigned i = 0; i < UPDATE_STARS; i++) {
+        s.add(Star(Enum::Star::GenType::RNG, cfg, rng, WORLD_W, WORLD_H));
+        shared.acquire(s.tips[i], s.iRadius[i], s.oRadius[i], s.style[i]);
+    }
+
+    runner.run("StarMeshes::acquire/shared", [&](unsigned n) {
+        for (unsigned i = 0; i < n; i++) {
+            unsigned k = i % s.size();
+            unsigned m = shared.acquire(s.tips[k], s.iRadius[k], s.oRadius[k], s.style[k]);
+
+            shared.release(m);
+            doNotOptimize(m);
+        }
+    });
+
+    for (int tips : SHAPE_TIPS) {
+        StarMeshes meshes;
+
+        runner.run("StarMeshes::acquire/new/tips=" + std::to_string(tips), [&](unsigned n) {
+            for (unsigned i = 0; i < n; i++) {
+                unsigned m = meshes.acquire(tips, 0.5, 1.0, {Star::Core::FULL, Star::Draw::FILL});
+
+                meshes.release(m);
+                doNotOptimize(m);
+            }
+        });
+    }
+}
+
+// the hue palette of the cycling color modes on the CPU (see SoftwareRasterizer), HUES hues per operation
+void hueBenchmarks(BenchmarkRunner& runner) {
+    std::vector<double> hues(HUES);
+
+    for (unsigned i = 0; i < HUES; i++) {
+        hues[i] = (i * 8.0) / HUES - 4.0; // a few turns in both directions
+    }
+
+    runner.run("SoftwareRasterizer::wrapHue", [&](unsigned n) {
+        for (unsigned i = 0; i < n; i++) {
+            for (double h : hues) {
+                double w = SoftwareRasterizer::wrapHue(h);
+                doNotOptimize(w);
+            }
+        }
+    }, HUES);
+
+    runner.run("SoftwareRasterizer::hue", [&](unsigned n) {
+        for (unsigned i = 0; i < n; i++) {
+            for (double h : hues) {
+                Color c = SoftwareRasterizer::hue(static_cast<float>(h + 4.0) * 0.25f);
+                doNotOptimize(c);
+            }
+        }
+    }, HUES);
+}
+
+void rngBenchmarks(BenchmarkRunner& runner, RNG& rng) {
+    runner.run("RNG::I", [&](unsigned n) {
+        for (unsigned i = 0; i < n; i++) {
+            int v = rng.I(0, 100);
+            doNotOptimize(v);
+        }
+    });
+
+    runner.run("RNG::F", [&](unsigned n) {
+        for (unsigned i = 0; i < n; i++) {
+            float v = rng.F(0.0f, 1.0f);
+            doNotOptimize(v);
+        }
+    });
+
+    runner.run("RNG::D", [&](unsigned n) {
+        for (unsigned i = 0; i < n; i++) {
+            double v = rng.D(0.0, 1.0);
+            doNotOptimize(v);
+        }
+    });
+
+    runner.run("RNG::DN", [&](unsigned n) {
+        for (unsigned i = 0; i < n; i++) {
+            double v = rng.DN(1.0, 2.0);
+            doNotOptimize(v);
+        }
+    });
+
+    runner.run("RNG::N", [&](unsigned n) {
+        for (unsigned i = 0; i < n; i++) {
+            double v = rng.N(1.0);
+            doNotOptimize(v);
+        }
+    });
+}
+
+int main(int argc, char** argv) {
+    BenchmarkRunner runner;
+    std::string out;
+
+    if (!parseArguments(argc, argv, runner, out)) return 1;
+
+    Config cfg;
+    RNG rng;
+    rng.mt.seed(1);
+
+    std::cerr << "stars_bench: kernels: integration " << StarSystem::integration.name << "; " << runner.repetitions << " repetitions of at least " << runner.minTime << " s\n";
+
+    collisionBenchmarks(runner, cfg, rng);
+    contactBenchmarks(runner);
+    updateBenchmarks(runner, cfg, rng);
+    shapeBenchmarks(runner);
+    meshBenchmarks(runner, cfg, rng);
+    hueBenchmarks(runner);
+    rngBenchmarks(runner, rng);
+
+    if (out.empty()) {
+        runner.writeJSON(std::cout);
+        return 0;
+    }
+
+    std::ofstream file(out);
+
+    if (!file) {
+        std::cerr << "EXCEPTION: main(): failed to open \"" << out << "\"\n";
+        return 1;
+    }
+
+    runner.writeJSON(file);
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+
+#include "benchmark.h"
+
+// calibrates and times one benchmark (unless the filter excludes it); items is the number of items per operation
+void BenchmarkRunner::run(const std::string& name, const Function& f, unsigned items) {
+    if (!filter.empty() && name.find(filter) == std::string::npos) return;
+
+    Result r;
+    r.name  = name;
+    r.items = items;
+
+    unsigned n = 1;
+
+    while (time(f, n) < minTime && n < (1u << 30)) {
+        n *= 2;
+    }
+
+    r.iterations = n;
+
+    for (unsigned i = 0; i < repetitions; i++) {
+        r.samples.push_back(time(f, n) * 1e9 / n);
+    }
+
+    summarize(r);
+
+    std::cerr << name << ": " << r.median << " ns (cv " << r.cv * 100.0 << "%)\n";
+
+    results.push_back(std::move(r));
+}
+
+void BenchmarkRunner::writeJSON(std::ostream& os) const {
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    auto number = [&](double v) {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.6g", v);
+        os << buffer;
+    };
+
+    os << "{\n  \"date\": \"" << date << "\",\n  \"unit\": \"ns\",\n  \"repetitions\": " << repetitions << ",\n  \"min_time\": ";
+    number(minTime);
+    os << ",\n  \"benchmarks\": [";
+
+    for (unsigned i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+
+        os << (i ? ",\n" : "\n") << "    {\"name\": \"" << escape(r.name) << "\", \"iterations\": " << r.iterations << ", \"items\": " << r.items << ", \"samples\": [";
+
+        for (unsigned s = 0; s < r.samples.size(); s++) {
+            if (s) os << ", ";
+            number(r.samples[s]);
+        }
+
+        os << "], \"min\": ";
+        number(r.min);
+        os << ", \"max\": ";
+        number(r.max);
+        os << ", \"mean\": ";
+        number(r.mean);
+        os << ", \"median\": ";
+        number(r.median);
+        os << ", \"stddev\": ";
+        number(r.stddev);
+        os << ", \"cv\": ";
+        number(r.cv);
+        os << "}";
+    }
+
+    os << "\n  ]\n}\n";
+}
+
+// seconds that f takes for n operations
+double BenchmarkRunner::time(const Function& f, unsigned n) {
+    Clock::time_point start = Clock::now();
+    f(n);
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void BenchmarkRunner::summarize(Result& r) {
+    if (r.samples.empty()) return;
+
+    std::vector<double> sorted = r.samples;
+    std::sort(sorted.begin(), sorted.end());
+
+    unsigned n = sorted.size();
+
+    r.min    = sorted.front();
+    r.max    = sorted.back();
+    r.median = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0;
+
+    double sum = 0.0;
+
+    for (double s : sorted) {
+        sum += s;
+    }
+
+    r.mean = sum / n;
+
+    double squares = 0.0;
+
+    for (double s : sorted) {
+        squares += (s - r.mean) * (s - r.mean);
+    }
+
+    // sample standard deviation
+    r.stddev = n > 1 ? std::sqrt(squares / (n - 1)) : 0.0;
+    r.cv     = r.mean > 0.0 ? r.stddev / r.mean : 0.0;
+}
+
+std::string BenchmarkRunner::escape(const std::string& s) {
+    std::string escaped;
+
+    for (char c : s) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+
+    return escaped;
+}
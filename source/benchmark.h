@@ -0,0 +1,59 @@
+#ifndef BENCHMARK_H_GUARD
+#define BENCHMARK_H_GUARD
+
+#include <chrono>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+Minimal microbenchmark runner of the benchmark target (stars_bench, see bench_main.cpp).
+
+A benchmark is a function that performs its operation n times.
+The runner first doubles n until one call takes at least minTime (which also warms up caches and branch predictors), then times repetitions calls of n operations.
+Every repetition yields one sample in nanoseconds per operation; the samples are summarized by min, max, mean, median, standard deviation, and coefficient of variation.
+
+Setup that must not be timed belongs outside the loop of the function (e.g. in a lambda capture).
+Results are written as JSON, so that runs can be compared by scripts (e.g. to gate performance regressions).
+*/
+struct BenchmarkRunner {
+    using Clock    = std::chrono::steady_clock;
+    using Function = std::function<void(unsigned)>;
+
+    struct Result {
+        std::string name;
+        unsigned iterations = 0; // operations per repetition
+        unsigned items      = 1; // items per operation (e.g. stars per update pass)
+
+        std::vector<double> samples; // ns per operation, one per repetition
+
+        double min    = 0.0;
+        double max    = 0.0;
+        double mean   = 0.0;
+        double median = 0.0;
+        double stddev = 0.0;
+        double cv     = 0.0; // stddev / mean
+    };
+
+    unsigned repetitions = 10;
+    double minTime       = 0.01; // seconds per repetition
+    std::string filter;          // only run benchmarks whose name contains this
+
+    std::vector<Result> results;
+
+    void run(const std::string&, const Function&, unsigned = 1);
+    void writeJSON(std::ostream&) const;
+
+    static double time(const Function&, unsigned);
+    static void summarize(Result&);
+    static std::string escape(const std::string&);
+};
+
+// keeps the compiler from optimizing away the computation of value (forces it to memory)
+template <typename T>
+inline void doNotOptimize(T& value) {
+    asm volatile("" : "+m"(value) : : "memory");
+}
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef BROADPHASE_H_GUARD
+#define BROADPHASE_H_GUARD
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// The collision circle of a star: center point and average radius (see StarSystem::collision() for why the average radius is used).
+struct CollisionCircle {
+    double x;
+    double y;
+    double r;
+};
+
+/*
+Candidate collision pairs produced by a broadphase.
+
+The candidates of star i are stored in indices[offsets[i]] to indices[offsets[i + 1] - 1].
+Every candidate j of star i satisfies j > i and the candidates of each star are sorted in ascending order.
+
+This is the same order in which the brute force loop in Simulation::collide() visits pairs, so StarSystem::collision() sees the pairs in the same order regardless of which broadphase produced them.
+*/
+struct CollisionCandidates {
+    std::vector<unsigned> offsets = {0};
+    std::vector<unsigned> indices;
+
+    // scratch space used by assign()
+    std::vector<unsigned> fill;
+
+    void clear() {
+        offsets.resize(1);
+        indices.clear();
+    }
+
+    // appends a candidate to the star that is currently being filled
+    void push(unsigned j) {
+        indices.push_back(j);
+    }
+
+    // finishes the star that is currently being filled; must be called once per star, in star order
+    void next() {
+        offsets.push_back(indices.size());
+    }
+
+    // replaces the candidates with an unordered list of pairs (in any orientation) between n stars
+    void assign(unsigned n, const std::vector<std::pair<unsigned, unsigned>>& pairs) {
+        offsets.assign(n + 1, 0);
+        indices.resize(pairs.size());
+
+        for (const auto& [a, b] : pairs) {
+            offsets[std::min(a, b) + 1]++;
+        }
+        for (unsigned i = 1; i <= n; i++) {
+            offsets[i] += offsets[i - 1];
+        }
+
+        fill.assign(offsets.begin(), offsets.end() - 1);
+
+        for (const auto& [a, b] : pairs) {
+            indices[fill[std::min(a, b)]++] = std::max(a, b);
+        }
+        for (unsigned i = 0; i < n; i++) {
+            std::sort(indices.begin() + offsets[i], indices.begin() + offsets[i + 1]);
+        }
+    }
+
+    const unsigned* begin(unsigned i) const {
+        return indices.data() + offsets[i];
+    }
+
+    const unsigned* end(unsigned i) const {
+        return indices.data() + offsets[i + 1];
+    }
+};
+
+#endif
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "config.h"
 
 Color::Color(float r, float g, float b, float a)
@@ -10,39 +12,6 @@ void Color::assign(float r, float g, float b, float a) {
     this->a = a;
 }
 
-// example of what this looks like: https://en.wikipedia.org/wiki/File:RBG_color_wheel.svg
-std::vector<Color> Color::getRGBColors() {
-    std::vector<Color> colors;
-    float alpha = 1.0f, step = 0.001f;
-
-    // red -> yellow
-    for (float i = 0.0f; i <= 1.0f; i += step) {
-        colors.emplace_back(Color(1.0f, i, 0.0f, alpha));
-    }
-    // yellow -> green
-    for (float i = 1.0f; i >= 0.0f; i -= step) {
-        colors.emplace_back(Color(i, 1.0f, 0.0f, alpha));
-    }
-    // green -> cyan
-    for (float i = 0.0f; i <= 1.0f; i += step) {
-        colors.emplace_back(Color(0.0f, 1.0f, i, alpha));
-    }
-    // cyan -> blue
-    for (float i = 1.0f; i >= 0.0f; i -= step) {
-        colors.emplace_back(Color(0.0f, i, 1.0f, alpha));
-    }
-    // blue -> magenta
-    for (float i = 0.0f; i <= 1.0f; i += step) {
-        colors.emplace_back(Color(i, 0.0f, 1.0f, alpha));
-    }
-    // magenta -> red
-    for (float i = 1.0f; i >= 0.0f; i -= step) {
-        colors.emplace_back(Color(1.0f, 0.0f, i, alpha));
-    }
-
-    return colors;
-}
-
 template <class Archive>
 void Color::serialize(Archive& a, const unsigned v) {
     a& r;
@@ -181,6 +150,22 @@ void Config::serialize(Archive& a, const unsigned v) {
     a& max;
 
     a& style;
+
+    if (v >= 1) a& broadphase;
+
+    if (v >= 2) {
+        a& verletLists;
+        a& verletSkin;
+    }
+
+    if (v >= 3) {
+        a& threads;
+        a& pinThreads;
+    }
+
+    if (v >= 4) a& parallelCollisions;
+
+    if (v >= 5) a& renderMode;
 }
 
 void Config::save(const std::string& path, const std::string& name, const std::string& extension) {
@@ -217,6 +202,9 @@ void Config::load(const std::string& path, const std::string& name, const std::s
         ia >> *this;
         ifs.close();
 
+        // a negative count would wrap around when it is passed on as unsigned (see JobSystem::start())
+        threads = std::clamp(threads, 0, MAX_THREADS);
+
         files.last = fullPath;
     } catch (std::exception& e) {
         std::cerr << "EXCEPTION: Config::load(): " << e.what() << '\n';
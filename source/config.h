@@ -11,6 +11,7 @@
 // https://www.boost.org/doc/libs/1_79_0/libs/serialization/doc/index.html
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
+#include <boost/serialization/version.hpp>
 
 #include "constants.h"
 #include "enums.h"
@@ -25,8 +26,6 @@ struct Color {
     Color(float, float, float, float);
     void assign(float, float, float, float);
 
-    static std::vector<Color> getRGBColors();
-
     template <class Archive>
     void serialize(Archive&, const unsigned);
 };
@@ -73,7 +72,9 @@ struct Files {
 };
 
 struct Config {
-    using ColorMode = Enum::Config::ColorMode;
+    using ColorMode  = Enum::Config::ColorMode;
+    using Broadphase = Enum::Config::Broadphase;
+    using RenderMode = Enum::Config::RenderMode;
 
     // DEFAULT: each star will have the color it was created with
     // RANDOM: each star will have a random color based on an index position in the rainbowColors vector
@@ -81,14 +82,31 @@ struct Config {
     // CONSISTENT: batches of stars that spawn at the same time will have the same color
     int colorMode = ColorMode::DEFAULT;
 
+    // BRUTE_FORCE: every star is tested against every other star (kept for comparison)
+    // SPATIAL_GRID: only stars that share a cell of a uniform grid are tested
+    // SWEEP_AND_PRUNE: only stars whose x extents overlap (tracked in a list kept sorted across frames) and whose y extents overlap are tested
+    // AABB_TREE: only stars whose bounding boxes overlap according to a dynamic bounding volume tree are tested (handles mixed star sizes best)
+    int broadphase = Broadphase::SPATIAL_GRID;
+
+    // MESH: stars are triangle meshes, smoothed by MSAA
+    // SDF: every star is a single quad whose fragment shader evaluates the distance to the star's outline, with analytic anti-aliasing (MSAA is turned off)
+    int renderMode = RenderMode::MESH;
+
     int srcBlendMode = 6;
     int dstBlendMode = 7;
     int addRemove    = 25;
     int targetFPS    = 500;
+    // number of job system workers (including the main thread); 0 == one per hardware thread
+    int threads = 0;
+    // loaded configs are clamped to this (see load())
+    static constexpr int MAX_THREADS = 256;
 
     bool show                           = true;
     bool clear                          = true;
     bool collisions                     = true;
+    bool parallelCollisions             = true;
+    bool verletLists                    = false;
+    bool pinThreads                     = false;
     bool gravity                        = false;
     bool minSpeed                       = false;
     bool maxSpeed                       = false;
@@ -104,6 +122,8 @@ struct Config {
     float maxSpeedLimit  = 1000;
     float accelMult      = 1;
     float minColor       = 0.0f;
+    // pixels: candidate lists are reused until some star has moved more than half of this distance
+    float verletSkin = 10.0f;
 
     Color backgroundColor;
 
@@ -125,4 +145,7 @@ struct Config {
     void reset();
 };
 
+// Incremented whenever fields are added to Config::serialize() so that older config files can still be loaded.
+BOOST_CLASS_VERSION(Config, 5)
+
 #endif
\ No newline at end of file
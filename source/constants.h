@@ -7,6 +7,9 @@ namespace Constants {
     inline constexpr double PI      = glm::pi<double>();
     inline constexpr double TWO_PI  = glm::two_pi<double>();
     inline constexpr double GRAVITY = 9.80665;
+
+    // steps per turn of the hue palette of the cycling color modes (cfg.colorShiftMult is in steps per second, see StarRenderer)
+    inline constexpr double HUE_STEPS = 6006.0;
 } // namespace Constants
 
 #endif
\ No newline at end of file
@@ -19,15 +19,21 @@ One requirement listed by the "human-readable summary" of this license states:
     "If you remix, transform, or build upon the material, you must distribute your contributions under the same license as the original."
 
 Consequently, the code in this elasticCollisionResponse() function is also licensed under Creative Commons Attribution-ShareAlike License 3.0.
+
+Coincident centers have no collision normal, so their velocities are left unchanged (overlapCorrection() separates them first, so this only happens if both radii are 0).
 */
 inline void elasticCollisionResponse(double a_x, double a_y, double b_x, double b_y,
                                      double& a_x_vel, double& a_y_vel, double& b_x_vel, double& b_y_vel,
                                      double a_mass, double b_mass) {
-    double x_temp = a_x - b_x;
-    double y_temp = a_y - b_y;
-    double temp   = 2.0 / (a_mass + b_mass) *
+    double x_temp   = a_x - b_x;
+    double y_temp   = a_y - b_y;
+    double distance = x_temp * x_temp + y_temp * y_temp; // squared
+
+    if (distance == 0.0) return;
+
+    double temp = 2.0 / (a_mass + b_mass) *
                   (((a_x_vel - b_x_vel) * x_temp + (a_y_vel - b_y_vel) * y_temp) /
-                   (pow(x_temp, 2) + pow(y_temp, 2)));
+                   distance);
 
     x_temp *= temp;
     y_temp *= temp;
@@ -30,6 +30,18 @@ namespace Enum {
             UNIFORM,
             CONSISTENT,
         };
+        // broadphase used to find the star pairs that are passed to StarSystem::collision()
+        enum Broadphase {
+            BRUTE_FORCE,
+            SPATIAL_GRID,
+            SWEEP_AND_PRUNE,
+            AABB_TREE,
+        };
+        // how the stars are rasterized
+        enum RenderMode {
+            MESH,
+            SDF,
+        };
     } // namespace Config
 } // namespace Enum
 
@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "frame_capture.h"
+
+FrameCapture::~FrameCapture() {
+    stop();
+}
+
+// starts writing w x h frames at fps frames per second to path (a file, or "|command" for a pipe); the current context must be the one that is captured
+bool FrameCapture::start(const std::string& path, Format f, int width, int height, int fps) {
+    if (active) return true;
+
+    if (path.empty() || width <= 0 || height <= 0) {
+        std::cerr << "FrameCapture::start(): no output or no frame size\n";
+        return false;
+    }
+
+    pipe = path[0] == '|';
+
+    if (pipe) {
+#ifdef _WIN32
+        file = _popen(path.c_str() + 1, "wb");
+#else
+        file = popen(path.c_str() + 1, "w");
+#endif
+    } else {
+        file = fopen(path.c_str(), "wb");
+    }
+
+    if (!file) {
+        std::cerr << "FrameCapture::start(): cannot open " << path << "\n";
+        return false;
+    }
+
+    w      = width;
+    h      = height;
+    format = f;
+
+    if (format == Y4M) fprintf(file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", w, h, fps);
+
+    for (Slot& s : slots) {
+        glGenBuffers(1, &s.buffer);
+
+        // clang-format off
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, s.buffer);
+            glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(w) * h * 4, NULL, GL_STREAM_READ);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        // clang-format on
+    }
+
+    head     = 0;
+    pending  = 0;
+    stopping = false;
+    failed   = false;
+
+    stats      = Stats();
+    latencySum = 0.0;
+
+    writer = std::thread(&FrameCapture::writerLoop, this);
+    active = true;
+
+    return true;
+}
+
+// writes out every frame that is still in flight or queued, then closes the output
+void FrameCapture::stop() {
+    if (!active) return;
+
+    collect(true);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    condition.notify_one();
+    writer.join();
+
+    if (pipe) {
+#ifdef _WIN32
+        _pclose(file);
+#else
+        pclose(file);
+#endif
+    } else {
+        fclose(file);
+    }
+
+    for (Slot& s : slots) {
+        glDeleteBuffers(1, &s.buffer);
+        s.buffer = 0;
+    }
+
+    file   = nullptr;
+    active = false;
+
+    spare.clear();
+}
+
+// queues the readback of the current frame of frameBuffer (0 == the back buffer of the window); must be called once the frame has been drawn
+void FrameCapture::capture(unsigned frameBuffer, int width, int height) {
+    if (!active) return;
+
+    collect(false);
+
+    if (width != w || height != h || pending == RING) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (width != w || height != h) stats.droppedSize++;
+        else stats.droppedGPU++;
+
+        return;
+    }
+
+    Slot& s = slots[head];
+
+    // clang-format off
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, frameBuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, s.buffer);
+        glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, NULL); // returns immediately: the copy goes into the buffer
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    // clang-format on
+
+    s.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    s.time  = Clock::now();
+
+    head = (head + 1) % RING;
+    pending++;
+}
+
+FrameCapture::Stats FrameCapture::snapshot() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Stats s   = stats;
+    s.latency = s.written ? latencySum / s.written : 0.0;
+
+    return s;
+}
+
+// moves the finished readbacks into the writer queue, oldest first; with wait, blocks until every readback in flight is finished
+void FrameCapture::collect(bool wait) {
+    while (pending > 0) {
+        Slot& s = slots[(head + RING - pending) % RING];
+
+        GLenum status = glClientWaitSync(s.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? 1000000000 : 0); // nanoseconds
+
+        if (status == GL_TIMEOUT_EXPIRED) {
+            if (wait) continue;
+            break;
+        }
+
+        glDeleteSync(s.fence);
+        s.fence = nullptr;
+        pending--;
+
+        std::unique_lock<std::mutex> lock(mutex);
+
+        // the copy may not have finished, so the buffer is not read
+        if (status == GL_WAIT_FAILED) {
+            stats.droppedGPU++;
+            continue;
+        }
+
+        if (failed || queue.size() >= QUEUE_DEPTH) {
+            stats.droppedWriter++;
+            continue;
+        }
+
+        Frame frame;
+        frame.time = s.time;
+
+        if (!spare.empty()) {
+            frame.pixels = std::move(spare.back());
+            spare.pop_back();
+        }
+
+        lock.unlock();
+
+        frame.pixels.resize(static_cast<size_t>(w) * h * 4);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, s.buffer);
+
+        const void* p = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frame.pixels.size(), GL_MAP_READ_BIT);
+
+        if (p) {
+            memcpy(frame.pixels.data(), p, frame.pixels.size());
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        lock.lock();
+
+        if (!p) {
+            stats.droppedWriter++;
+            spare.push_back(std::move(frame.pixels));
+            continue;
+        }
+
+        stats.captured++;
+        queue.push_back(std::move(frame));
+
+        lock.unlock();
+        condition.notify_one();
+    }
+}
+
+void FrameCapture::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        condition.wait(lock, [this] { return stopping || !queue.empty(); });
+
+        if (queue.empty()) break; // stopping, and every frame has been written
+
+        Frame frame = std::move(queue.front());
+        queue.pop_front();
+
+        lock.unlock();
+
+        bool written = !failed && write(frame);
+        double ms    = std::chrono::duration<double, std::milli>(Clock::now() - frame.time).count();
+
+        lock.lock();
+
+        if (written) {
+            stats.written++;
+            stats.maxLatency = std::max(stats.maxLatency, ms);
+            latencySum += ms;
+        } else {
+            if (!failed) std::cerr << "FrameCapture::writerLoop(): write failed, the remaining frames are dropped\n";
+
+            failed = true;
+            stats.droppedWriter++;
+        }
+
+        spare.push_back(std::move(frame.pixels));
+    }
+}
+
+// writer thread: writes one frame in the format of the stream
+bool FrameCapture::write(const Frame& frame) {
+    const unsigned char* pixels = frame.pixels.data();
+    size_t row                  = static_cast<size_t>(w) * 4;
+
+    switch (format) {
+        using enum Format;
+
+        case RAW: {
+            // glReadPixels() returns the rows bottom-up
+            for (int y = h - 1; y >= 0; y--) {
+                if (fwrite(pixels + y * row, 1, row, file) != row) return false;
+            }
+
+            break;
+        }
+        case Y4M: {
+            size_t plane = static_cast<size_t>(w) * h;
+            converted.resize(plane * 3);
+
+            unsigned char* Y = converted.data();
+            unsigned char* U = Y + plane;
+            unsigned char* V = U + plane;
+
+            // BT.601, limited range, in 8-bit fixed point
+            for (int y = 0; y < h; y++) {
+                const unsigned char* p = pixels + (h - 1 - y) * row;
+
+                for (int x = 0; x < w; x++, p += 4) {
+                    int r = p[0], g = p[1], b = p[2];
+
+                    *Y++ = static_cast<unsigned char>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+                    *U++ = static_cast<unsigned char>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+                    *V++ = static_cast<unsigned char>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+                }
+            }
+
+            if (fputs("FRAME\n", file) == EOF) return false;
+            if (fwrite(converted.data(), 1, converted.size(), file) != converted.size()) return false;
+
+            break;
+        }
+    }
+
+    return true;
+}
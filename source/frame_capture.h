@@ -0,0 +1,100 @@
+#ifndef FRAME_CAPTURE_H_GUARD
+#define FRAME_CAPTURE_H_GUARD
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glad/gl.h>
+
+/*
+Records the frames of a framebuffer into a raw video stream without stalling the render loop.
+
+Every captured frame is read into one of RING pixel pack buffers with glReadPixels(), which only queues the copy, and a fence is placed after it.
+The following frames poll the fences of the buffers in flight; once a copy is done, the buffer is mapped, its pixels are copied into a frame of the writer queue, and the buffer is free again.
+A writer thread takes the frames from the queue and writes them to a file or a pipe (path "|command", e.g. "|ffmpeg -i - out.mp4").
+
+Nothing ever waits for the GPU or the writer: a frame is dropped if all pixel pack buffers are still in flight, or if QUEUE_DEPTH frames already wait for the writer.
+The size of the stream is fixed when capturing starts; frames of another size (e.g. after resizing the window) are dropped as well.
+
+Formats:
+    Y4M: YUV4MPEG2 with 4:4:4 BT.601 (limited range) frames, which ffmpeg and most players read directly
+    RAW: top-down RGBA rows, 4 bytes per pixel (ffmpeg: -f rawvideo -pixel_format rgba -video_size WxH)
+
+The pixel pack buffers belong to the context that was current when capturing started.
+*/
+struct FrameCapture {
+    using Clock = std::chrono::steady_clock;
+
+    enum Format {
+        Y4M,
+        RAW,
+    };
+
+    static constexpr unsigned RING        = 4; // pixel pack buffers
+    static constexpr unsigned QUEUE_DEPTH = 8; // frames waiting for the writer
+
+    struct Slot {
+        unsigned buffer = 0;
+        GLsync fence    = nullptr;
+        Clock::time_point time; // when the frame was captured
+    };
+
+    struct Frame {
+        std::vector<unsigned char> pixels; // bottom-up RGBA rows, as read by glReadPixels()
+        Clock::time_point time;
+    };
+
+    struct Stats {
+        unsigned captured      = 0; // read back into the writer queue
+        unsigned written       = 0;
+        unsigned droppedGPU    = 0; // all pixel pack buffers still in flight, or waiting for the copy failed
+        unsigned droppedWriter = 0; // writer queue full (or the output failed)
+        unsigned droppedSize   = 0; // framebuffer size differs from the stream
+        double latency         = 0.0; // average ms from capture() to the frame being written
+        double maxLatency      = 0.0; // ms
+    };
+
+    int w         = 0;
+    int h         = 0;
+    Format format = Y4M;
+    FILE* file    = nullptr;
+    bool pipe     = false;
+    bool active   = false;
+
+    Slot slots[RING];
+    unsigned head    = 0; // next slot to capture into
+    unsigned pending = 0; // slots in flight, the oldest being (head - pending) % RING
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<Frame> queue;
+    std::vector<std::vector<unsigned char>> spare; // pixel memory of written frames, for reuse
+    bool stopping = false;
+    bool failed   = false;
+
+    // guarded by mutex
+    Stats stats;
+    double latencySum = 0.0;
+
+    std::vector<unsigned char> converted; // writer thread only
+
+    ~FrameCapture();
+
+    bool start(const std::string&, Format, int, int, int);
+    void stop();
+    void capture(unsigned, int, int);
+    Stats snapshot();
+
+    void collect(bool);
+    void writerLoop();
+    bool write(const Frame&);
+};
+
+#endif
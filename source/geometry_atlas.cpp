@@ -0,0 +1,203 @@
+#include <algorithm>
+
+#include "geometry_atlas.h"
+
+// bytes per element
+static constexpr unsigned VERTEX_SIZE = 2 * sizeof(float); // <x, y>
+static constexpr unsigned INDEX_SIZE  = sizeof(unsigned);
+
+// takes size elements from the first free range that is large enough
+bool GeometryAtlas::Arena::allocate(unsigned size, Range& r) {
+    for (unsigned i = 0; i < free.size(); i++) {
+        Range& f = free[i];
+
+        if (f.size < size) continue;
+
+        r = {f.offset, size};
+
+        f.offset += size;
+        f.size -= size;
+
+        if (f.size == 0) free.erase(free.begin() + i);
+
+        used += size;
+        return true;
+    }
+
+    return false;
+}
+
+// returns the range to the free list, merging it with its neighbours
+void GeometryAtlas::Arena::deallocate(const Range& r) {
+    used -= r.size;
+
+    auto it = std::lower_bound(free.begin(), free.end(), r.offset, [](const Range& f, unsigned offset) { return f.offset < offset; });
+    it      = free.insert(it, r);
+
+    if (it + 1 != free.end() && it->offset + it->size == (it + 1)->offset) {
+        it->size += (it + 1)->size;
+        free.erase(it + 1);
+    }
+
+    if (it != free.begin() && (it - 1)->offset + (it - 1)->size == it->offset) {
+        (it - 1)->size += it->size;
+        free.erase(it);
+    }
+}
+
+// the first used elements are taken, the rest is one free range
+void GeometryAtlas::Arena::reset(unsigned newCapacity, unsigned newUsed) {
+    capacity = newCapacity;
+    used     = newUsed;
+
+    free.clear();
+
+    if (used < capacity) free.push_back({used, capacity - used});
+}
+
+// GL objects are released by destroy() while the context is still current; this only catches atlases that still exist at exit
+GeometryAtlas::~GeometryAtlas() {
+    destroy();
+}
+
+// copies the geometry of the shape into the atlas and returns its block
+unsigned GeometryAtlas::add(const Shape& shape) {
+    unsigned vertexCount = shape.verticesSize / 2;
+    unsigned indexCount  = shape.indicesSize;
+
+    if (!vertexArray) {
+        glGenVertexArrays(1, &vertexArray);
+        compact(std::max(INITIAL_VERTICES, vertexCount), std::max(INITIAL_INDICES, indexCount));
+    }
+
+    Range v, i;
+
+    bool fits = vertexArena.allocate(vertexCount, v);
+
+    if (fits && !indexArena.allocate(indexCount, i)) {
+        vertexArena.deallocate(v);
+        fits = false;
+    }
+
+    // after compaction, all free space is one range at the end of each buffer
+    if (!fits) {
+        unsigned vertexCapacity = vertexArena.capacity;
+        unsigned indexCapacity  = indexArena.capacity;
+
+        while (vertexArena.used + vertexCount > vertexCapacity) vertexCapacity *= 2;
+        while (indexArena.used + indexCount > indexCapacity) indexCapacity *= 2;
+
+        compact(vertexCapacity, indexCapacity);
+
+        vertexArena.allocate(vertexCount, v);
+        indexArena.allocate(indexCount, i);
+    }
+
+    unsigned b;
+
+    if (freeBlocks.empty()) {
+        b = blocks.size();
+        blocks.emplace_back();
+    } else {
+        b = freeBlocks.back();
+        freeBlocks.pop_back();
+    }
+
+    blocks[b] = {v, i, true};
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, vertexBuffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, v.offset * VERTEX_SIZE, vertexCount * VERTEX_SIZE, shape.vertices.get());
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, indexBuffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, i.offset * INDEX_SIZE, indexCount * INDEX_SIZE, shape.indices.get());
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    return b;
+}
+
+void GeometryAtlas::remove(unsigned b) {
+    Block& block = blocks[b];
+
+    vertexArena.deallocate(block.vertices);
+    indexArena.deallocate(block.indices);
+
+    block.live = false;
+    freeBlocks.push_back(b);
+}
+
+const GeometryAtlas::Block& GeometryAtlas::operator[](unsigned b) const {
+    return blocks[b];
+}
+
+// moves the live blocks to the front of new buffers with the given capacities (in elements)
+void GeometryAtlas::compact(unsigned vertexCapacity, unsigned indexCapacity) {
+    unsigned buffers[2];
+    glGenBuffers(2, buffers);
+
+    // copies every live block's range (selected by member) from the old to the new buffer, packed, and returns the number of elements copied
+    auto move = [&](unsigned from, unsigned to, unsigned capacity, unsigned size, Range Block::*member) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, to);
+        glBufferData(GL_COPY_WRITE_BUFFER, capacity * size, NULL, GL_STATIC_DRAW);
+
+        unsigned offset = 0;
+
+        if (from) {
+            glBindBuffer(GL_COPY_READ_BUFFER, from);
+
+            for (Block& b : blocks) {
+                if (!b.live) continue;
+
+                Range& r = b.*member;
+
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, r.offset * size, offset * size, r.size * size);
+
+                r.offset = offset;
+                offset += r.size;
+            }
+
+            glDeleteBuffers(1, &from);
+        }
+
+        return offset;
+    };
+
+    vertexArena.reset(vertexCapacity, move(vertexBuffer, buffers[0], vertexCapacity, VERTEX_SIZE, &Block::vertices));
+    indexArena.reset(indexCapacity, move(indexBuffer, buffers[1], indexCapacity, INDEX_SIZE, &Block::indices));
+
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    vertexBuffer = buffers[0];
+    indexBuffer  = buffers[1];
+
+    // the vertex array keeps the instance attributes of the renderer, only the atlas buffers are replaced
+    // clang-format off
+    glBindVertexArray(vertexArray);
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, VERTEX_SIZE, (void*)0);
+        glEnableVertexAttribArray(0);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // clang-format on
+}
+
+void GeometryAtlas::destroy() {
+    if (!vertexArray) return;
+
+    glDeleteVertexArrays(1, &vertexArray);
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteBuffers(1, &indexBuffer);
+
+    vertexArray  = 0;
+    vertexBuffer = 0;
+    indexBuffer  = 0;
+
+    vertexArena = {};
+    indexArena  = {};
+
+    blocks.clear();
+    freeBlocks.clear();
+}
@@ -0,0 +1,71 @@
+#ifndef GEOMETRY_ATLAS_H_GUARD
+#define GEOMETRY_ATLAS_H_GUARD
+
+#include <vector>
+
+#include <glad/gl.h>
+
+#include "shape.h"
+
+/*
+Shared vertex/index storage for star meshes.
+
+Every mesh used to have its own vertex buffer, index buffer, and vertex array, which meant one vertex array bind per mesh per frame.
+Now the vertices and indices of all meshes are sub-allocated from one vertex buffer and one index buffer, read through a single vertex array.
+A mesh is addressed by its first index and base vertex, so its indices stay relative to its own vertices and never have to be rewritten.
+
+Each buffer is managed by an Arena: a first fit allocator over a free list that is kept sorted by offset, with adjacent free ranges merged.
+When an allocation does not fit into any free range, the atlas is compacted: the live blocks are copied (on the GPU) to the front of new buffers, which leaves a single free range at the end.
+The new buffers are twice as large if the live blocks plus the new one would not fit otherwise.
+
+All vertices have the same format: <x, y> floats at vertex attribute location 0.
+The atlas owns GL objects, so it belongs to the context that was current when the first block was added.
+*/
+struct GeometryAtlas {
+    static constexpr unsigned INITIAL_VERTICES = 4096;
+    static constexpr unsigned INITIAL_INDICES  = 8192;
+
+    struct Range {
+        unsigned offset;
+        unsigned size;
+    };
+
+    // sub-allocator over a buffer of capacity elements
+    struct Arena {
+        unsigned capacity = 0;
+        unsigned used     = 0;
+        std::vector<Range> free;
+
+        bool allocate(unsigned, Range&);
+        void deallocate(const Range&);
+        void reset(unsigned, unsigned);
+    };
+
+    // vertices and indices of one mesh, in elements (<x, y> pairs and indices)
+    struct Block {
+        Range vertices;
+        Range indices;
+        bool live = false;
+    };
+
+    unsigned vertexBuffer = 0;
+    unsigned indexBuffer  = 0;
+    unsigned vertexArray  = 0;
+
+    Arena vertexArena;
+    Arena indexArena;
+
+    std::vector<Block> blocks;
+    std::vector<unsigned> freeBlocks;
+
+    ~GeometryAtlas();
+
+    unsigned add(const Shape&);
+    void remove(unsigned);
+    const Block& operator[](unsigned) const;
+
+    void compact(unsigned, unsigned);
+    void destroy();
+};
+
+#endif
@@ -0,0 +1,172 @@
+#include <cstddef>
+#include <iterator>
+
+#include "instanced_renderer.h"
+
+// releases mesh m of StarMeshes::acquire() along with the atlas blocks of the meshes that it deletes
+void InstancedRenderer::release(unsigned m) {
+    freed.clear();
+    meshes.release(m, &freed);
+
+    // meshes that were never uploaded have no draw state yet
+    for (unsigned f : freed) {
+        if (f >= draws.size() || draws[f].block == NO_BLOCK) continue;
+
+        atlas.remove(draws[f].block);
+        draws[f].block = NO_BLOCK;
+    }
+
+    // the last mesh releases the shared GL objects, while the context is still current
+    if (meshes.empty()) {
+        if (program) ProgramRegistry::release(programKey);
+        program = 0;
+
+        atlas.destroy();
+        instances.destroy();
+        commands.destroy();
+        instancesVersion = 0;
+        fencePending     = false;
+
+        draws.clear();
+    }
+}
+
+// creates the program and adds the meshes that have not been drawn yet to the atlas; requires the context of the renderer
+void InstancedRenderer::upload() {
+    // nothing would release the program again
+    if (meshes.empty()) return;
+
+    if (!program) {
+        programKey = ProgramRegistry::acquire(ProgramRegistry::INSTANCED);
+        program    = ProgramRegistry::get(programKey);
+    }
+
+    draws.resize(meshes.meshes.size());
+
+    for (unsigned m = 0; m < draws.size(); m++) {
+        if (meshes.meshes[m].references > 0 && draws[m].block == NO_BLOCK) draws[m].block = atlas.add(*meshes.meshes[m].shape);
+    }
+}
+
+// returns the instance memory of this frame: the instance of star i (which uses mesh[i]) goes to slots[i]
+InstancedRenderer::Instance* InstancedRenderer::begin(const std::vector<unsigned>& mesh) {
+    upload();
+
+    // the draws of the last frame have been executed by now
+    if (fencePending) {
+        instances.fence();
+        commands.fence();
+        fencePending = false;
+    }
+
+    // counting sort by mesh (stable, so star order is kept within a mesh)
+    for (MeshDraw& d : draws) {
+        d.count = 0;
+    }
+
+    for (unsigned m : mesh) {
+        draws[m].count++;
+    }
+
+    unsigned first = 0;
+
+    for (MeshDraw& d : draws) {
+        d.first = first;
+        first += d.count;
+        d.count = 0;
+    }
+
+    slots.resize(mesh.size());
+
+    for (unsigned i = 0; i < mesh.size(); i++) {
+        MeshDraw& d = draws[mesh[i]];
+        slots[i]    = d.first + d.count++;
+    }
+
+    return static_cast<Instance*>(instances.map(mesh.size() * sizeof(Instance)));
+}
+
+// submits the draws of the instances written since begin() to the queue
+void InstancedRenderer::end(RenderQueue& queue, RenderQueue::Layer layer, const RenderQueue::Blend& blend, const glm::mat4& projection, const glm::vec2& palette) {
+    instances.finish();
+
+    unsigned drawn = 0;
+
+    for (const MeshDraw& d : draws) {
+        if (d.count > 0) drawn++;
+    }
+
+    RenderQueue::Indirect* c = static_cast<RenderQueue::Indirect*>(commands.map(drawn * sizeof(RenderQueue::Indirect)));
+
+    if (!c) return;
+
+    // the commands of each mode are contiguous: MODES[k] uses commands first[k] to first[k + 1] - 1
+    constexpr unsigned N = std::size(MODES);
+    unsigned first[N + 1];
+    unsigned base = instances.offset() / sizeof(Instance);
+
+    first[0] = 0;
+
+    for (unsigned k = 0; k < N; k++) {
+        first[k + 1] = first[k];
+
+        for (unsigned m = 0; m < draws.size(); m++) {
+            const MeshDraw& d = draws[m];
+
+            if (d.count == 0 || static_cast<unsigned>(meshes.meshes[m].shape->primitive) != k) continue;
+
+            const GeometryAtlas::Block& b = atlas[d.block];
+
+            c[first[k + 1]++] = {b.indices.size, d.count, b.indices.offset, static_cast<int>(b.vertices.offset), base + d.first};
+        }
+    }
+
+    commands.finish();
+
+    if (instancesVersion != instances.version) bindInstanceAttributes();
+
+    RenderQueue::Command draw;
+    draw.program        = program;
+    draw.vertexArray    = atlas.vertexArray;
+    draw.blend          = blend;
+    draw.indirectBuffer = commands.buffer;
+    draw.projection     = projection;
+    draw.palette        = palette;
+
+    for (unsigned k = 0; k < N; k++) {
+        if (first[k + 1] == first[k]) continue;
+
+        draw.mode      = MODES[k];
+        draw.indirect  = commands.offset() + first[k] * sizeof(RenderQueue::Indirect);
+        draw.drawCount = first[k + 1] - first[k];
+
+        queue.submit(layer, 0, draw);
+    }
+
+    // the draws are only issued when the queue is executed, so the regions are fenced by the next begin()
+    fencePending = true;
+}
+
+// instancedVertexSource: location == 1: <x, y, angle, scale>, location == 2: color, location == 3: hue; all advance once per instance
+void InstancedRenderer::bindInstanceAttributes() {
+    instancesVersion = instances.version;
+
+    // clang-format off
+    glBindVertexArray(atlas.vertexArray);
+        glBindBuffer(GL_ARRAY_BUFFER, instances.buffer);
+
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, x));
+        glEnableVertexAttribArray(1);
+        glVertexAttribDivisor(1, 1);
+
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, color));
+        glEnableVertexAttribArray(2);
+        glVertexAttribDivisor(2, 1);
+
+        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, hue));
+        glEnableVertexAttribArray(3);
+        glVertexAttribDivisor(3, 1);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // clang-format on
+}
@@ -0,0 +1,81 @@
+#ifndef INSTANCED_RENDERER_H_GUARD
+#define INSTANCED_RENDERER_H_GUARD
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "config.h"
+#include "geometry_atlas.h"
+#include "render_queue.h"
+#include "shader.h"
+#include "star_meshes.h"
+#include "streaming_buffer.h"
+
+/*
+Instanced star renderer: draws the star meshes (see star_meshes.h) with one instance per star.
+
+The position, angle, scale, color, and hue phase of each star are per-instance attributes; the transform (and the color, in the cycling color modes) is built in the vertex shader.
+
+The geometry of all meshes lives in one geometry atlas (see geometry_atlas.h), so every mesh is drawn through the same vertex array.
+Each frame, one indirect draw command per mesh is written to a streaming buffer and all of them are drawn with glMultiDrawElementsIndirect().
+A draw call has a single primitive mode, so there is one call per mode that is in use (filled stars, line stars, points): at most 3 draw calls per frame, however many meshes there are.
+The draw calls are submitted to a render queue (see render_queue.h) instead of being issued directly.
+
+The instances of all meshes live in one streaming buffer (see streaming_buffer.h): the instances of each mesh are contiguous and selected with the base instance of its command.
+begin() returns the mapped memory and the slot of every star in it, so the draw pass writes the instance data straight into the buffer.
+Within a mesh, stars are drawn in star order.
+
+The geometry of a mesh is built on the CPU when the mesh is acquired and uploaded to the atlas by the next begin(), which also creates the program, so stars can be added without a context.
+A renderer owns GL objects, so it belongs to a single context: every StarRenderer has its own.
+*/
+struct InstancedRenderer {
+    struct Instance {
+        float x;
+        float y;
+        float angle;
+        float scale; // outer radius
+        Color color;
+        float hue; // hue phase of the star in turns, see RenderQueue::Command::palette
+    };
+
+    static constexpr unsigned NO_BLOCK = ~0u; // the geometry of the mesh has not been uploaded yet
+
+    // GL state of the mesh with the same index
+    struct MeshDraw {
+        unsigned block = NO_BLOCK; // in the geometry atlas
+
+        // range of the mesh in the instance buffer during begin()/end()
+        unsigned first = 0;
+        unsigned count = 0;
+    };
+
+    // primitive modes of star meshes, in draw order and in the order of Shape::Primitive
+    static constexpr GLenum MODES[] = {GL_TRIANGLES, GL_LINE_STRIP, GL_POINTS};
+
+    StarMeshes meshes;
+    std::vector<MeshDraw> draws;
+    std::vector<unsigned> freed; // meshes deleted by the last release()
+
+    ProgramRegistry::Key programKey;
+    unsigned program = 0;
+    GeometryAtlas atlas;
+
+    StreamingBuffer instances;
+    std::vector<unsigned> slots; // star index -> instance index
+    unsigned instancesVersion = 0; // version of the instance buffer that the atlas vertex array reads from
+
+    StreamingBuffer commands;
+    bool fencePending = false;
+
+    void release(unsigned);
+
+    void upload();
+
+    Instance* begin(const std::vector<unsigned>&);
+    void end(RenderQueue&, RenderQueue::Layer, const RenderQueue::Blend&, const glm::mat4&, const glm::vec2&);
+
+    void bindInstanceAttributes();
+};
+
+#endif
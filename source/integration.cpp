@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <cmath>
+
+#include "integration.h"
+#include "simd.h"
+#include "constants.h"
+#include "rng.h"
+
+// the kernels run on the worker threads of the job system and the global rng is not thread-safe, so each thread gets its own
+static thread_local RNG integrationRNG;
+
+static void forceMove(double& xVel, double& yVel, double frameTime) {
+    xVel += integrationRNG.DN(1, 1000) * frameTime;
+    yVel += integrationRNG.DN(1, 1000) * frameTime;
+}
+
+template <unsigned F>
+static void integrateScalarFeatures(const IntegrationParams& p, const IntegrationArrays& a, unsigned begin, unsigned end) {
+    using namespace IntegrationFeature;
+
+    for (unsigned i = begin; i < end; i++) {
+        double& x    = a.x[i];
+        double& y    = a.y[i];
+        double& xVel = a.xVel[i];
+        double& yVel = a.yVel[i];
+        double r     = a.oRadius[i];
+
+        if constexpr ((F & GRAVITY) != 0) yVel += p.gravityStep;
+
+        if constexpr ((F & ACCEL) != 0) {
+            if (xVel == 0.0 && yVel == 0.0) forceMove(xVel, yVel, p.frameTime);
+
+            xVel *= p.accelMult;
+            yVel *= p.accelMult;
+        }
+
+        if constexpr ((F & (MIN_SPEED | MAX_SPEED)) != 0) {
+            double speed = sqrt(pow(xVel, 2) + pow(yVel, 2));
+
+            if ((F & MIN_SPEED) != 0 && speed < p.minSpeedLimit) {
+                if (xVel == 0.0 && yVel == 0.0) forceMove(xVel, yVel, p.frameTime);
+
+                double speedCapMult = p.minSpeedLimit / speed;
+                xVel *= speedCapMult;
+                yVel *= speedCapMult;
+            }
+
+            if ((F & MAX_SPEED) != 0 && speed > p.maxSpeedLimit) {
+                double speedCapMult = p.maxSpeedLimit / speed;
+                xVel *= speedCapMult;
+                yVel *= speedCapMult;
+            }
+        }
+
+        x += xVel * p.frameTime;
+        y += yVel * p.frameTime;
+        a.ang[i] = fmod(a.ang[i] + a.angVel[i] * p.frameTime, Constants::TWO_PI);
+
+        // reflect off the walls
+        if (x <= r && xVel < 0.0) {
+            xVel = -xVel;
+            x    = std::max(0.0, r + r - x);
+        } else if (x >= p.xMax - r && xVel > 0.0) {
+            xVel = -xVel;
+            x    = std::min(p.xMax - r, (p.xMax - r) - ((p.xMax - r) - x));
+        }
+
+        if (y <= r && yVel < 0.0) {
+            yVel = -yVel;
+            y    = std::max(0.0, r + r - y);
+        } else if (y >= p.yMax - r && yVel > 0.0) {
+            yVel = -yVel;
+            y    = std::min(p.yMax - r, (p.yMax - r) - ((p.yMax - r) - y));
+        }
+    }
+}
+
+void integrateScalar(const IntegrationParams& p, const IntegrationArrays& a, unsigned begin, unsigned end) {
+    static constexpr auto kernels = makeIntegrationTable([](auto f) { return &integrateScalarFeatures<decltype(f)::value>; });
+
+    kernels[p.features](p, a, begin, end);
+}
+
+IntegrationKernelInfo selectIntegrationKernel() {
+    SIMDLevel level = detectSIMDLevel();
+
+    switch (level) {
+        using enum SIMDLevel;
+
+        case SSE2: {
+            return {getName(level), integrateSSE2};
+        }
+        case AVX2: {
+            return {getName(level), integrateAVX2};
+        }
+        case AVX512: {
+            return {getName(level), integrateAVX512};
+        }
+        default: {
+            return {getName(level), integrateScalar};
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef INTEGRATION_H_GUARD
+#define INTEGRATION_H_GUARD
+
+#include <array>
+#include <type_traits>
+#include <utility>
+
+/*
+Integration pass kernels: gravity, acceleration multiplier, min/max speed clamping, position/angle integration, and wall reflection.
+
+integrateScalar() is the reference implementation.
+The SIMD kernels process 2 (SSE2), 4 (AVX2), or 8 (AVX-512) stars at once and replace the branches of the reference with lane masks.
+They produce bit-identical results: every lane performs the same IEEE operations in the same order as the reference.
+
+Two cases are rare and hard to express with masks, so a SIMD kernel hands the whole block of stars to the reference instead:
+    - a star without any velocity has to be nudged in a random direction (forceMove)
+    - an angle that moved by a full turn or more in one frame (fmod() is only reproduced exactly for less than that)
+*/
+
+/*
+Parts of the integration pass that can be enabled independently.
+
+Every kernel is compiled once per combination of features (2^COUNT instantiations) and a kernel call dispatches once through a table indexed by the feature bitmask.
+The inner loops therefore contain no branches on the config.
+*/
+namespace IntegrationFeature {
+    inline constexpr unsigned GRAVITY   = 1 << 0;
+    inline constexpr unsigned ACCEL     = 1 << 1;
+    inline constexpr unsigned MIN_SPEED = 1 << 2;
+    inline constexpr unsigned MAX_SPEED = 1 << 3;
+
+    inline constexpr unsigned COUNT        = 4;
+    inline constexpr unsigned COMBINATIONS = 1 << COUNT;
+} // namespace IntegrationFeature
+
+struct IntegrationParams {
+    unsigned features; // IntegrationFeature bitmask
+
+    double frameTime;
+    double gravityStep; // velocity added by gravity this frame
+    double accelMult;   // velocity multiplier of the acceleration this frame
+    double minSpeedLimit;
+    double maxSpeedLimit;
+
+    // the walls are at 0 and xMax/yMax
+    double xMax;
+    double yMax;
+};
+
+struct IntegrationArrays {
+    double* x;
+    double* y;
+    double* xVel;
+    double* yVel;
+    double* ang;
+    const double* angVel;
+    const double* oRadius;
+};
+
+using IntegrationKernel = void (*)(const IntegrationParams&, const IntegrationArrays&, unsigned, unsigned);
+
+struct IntegrationKernelInfo {
+    const char* name;
+    IntegrationKernel kernel;
+};
+
+// table of get(std::integral_constant<unsigned, F>()) for every feature bitmask F
+template <typename Get>
+constexpr std::array<IntegrationKernel, IntegrationFeature::COMBINATIONS> makeIntegrationTable(Get get) {
+    return [&]<unsigned... F>(std::integer_sequence<unsigned, F...>) {
+        return std::array<IntegrationKernel, sizeof...(F)>{get(std::integral_constant<unsigned, F>())...};
+    }(std::make_integer_sequence<unsigned, IntegrationFeature::COMBINATIONS>());
+}
+
+// all kernels integrate stars [begin, end)
+void integrateScalar(const IntegrationParams&, const IntegrationArrays&, unsigned, unsigned);
+void integrateSSE2(const IntegrationParams&, const IntegrationArrays&, unsigned, unsigned);
+void integrateAVX2(const IntegrationParams&, const IntegrationArrays&, unsigned, unsigned);
+void integrateAVX512(const IntegrationParams&, const IntegrationArrays&, unsigned, unsigned);
+
+// widest kernel supported by the CPU the program runs on (see simd.h)
+IntegrationKernelInfo selectIntegrationKernel();
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef INTEGRATION_SIMD_H_GUARD
+#define INTEGRATION_SIMD_H_GUARD
+
+#include "integration.h"
+#include "constants.h"
+
+// SIMD version of integrateScalar() for the instruction set wrapped by V (see simd.h) and the features F
+template <typename V, unsigned F>
+void integrateSIMDFeatures(const IntegrationParams& p, const IntegrationArrays& a, unsigned begin, unsigned end) {
+    using namespace IntegrationFeature;
+
+    using D = typename V::D;
+    using M = typename V::M;
+
+    const D zero      = V::set(0.0);
+    const D frameTime = V::set(p.frameTime);
+    const D gravity   = V::set(p.gravityStep);
+    const D accel     = V::set(p.accelMult);
+    const D minSpeed  = V::set(p.minSpeedLimit);
+    const D maxSpeed  = V::set(p.maxSpeedLimit);
+    const D xMax      = V::set(p.xMax);
+    const D yMax      = V::set(p.yMax);
+    const D turn      = V::set(Constants::TWO_PI);
+    const D turns     = V::set(2.0 * Constants::TWO_PI);
+
+    unsigned i = begin;
+
+    for (; i + V::WIDTH <= end; i += V::WIDTH) {
+        D x    = V::load(a.x + i);
+        D y    = V::load(a.y + i);
+        D xVel = V::load(a.xVel + i);
+        D yVel = V::load(a.yVel + i);
+        D ang  = V::add(V::load(a.ang + i), V::mul(V::load(a.angVel + i), frameTime));
+        D r    = V::load(a.oRadius + i);
+
+        if constexpr ((F & GRAVITY) != 0) yVel = V::add(yVel, gravity);
+
+        // stars that have to be nudged by forceMove() and angles that fmod() would reduce by more than one turn
+        M fallback = V::ge(V::max(ang, V::neg(ang)), turns);
+
+        if constexpr ((F & (ACCEL | MIN_SPEED)) != 0) fallback = V::or_(fallback, V::and_(V::eq(xVel, zero), V::eq(yVel, zero)));
+
+        if (V::any(fallback)) {
+            integrateScalar(p, a, i, i + V::WIDTH);
+            continue;
+        }
+
+        if constexpr ((F & ACCEL) != 0) {
+            xVel = V::mul(xVel, accel);
+            yVel = V::mul(yVel, accel);
+        }
+
+        if constexpr ((F & (MIN_SPEED | MAX_SPEED)) != 0) {
+            D speed = V::sqrt(V::add(V::mul(xVel, xVel), V::mul(yVel, yVel)));
+
+            if constexpr ((F & MIN_SPEED) != 0) {
+                M slow = V::lt(speed, minSpeed);
+
+                // the multiplication above cannot produce a zero velocity from a non-zero one in practice, but be exact about it
+                if (V::any(V::and_(slow, V::and_(V::eq(xVel, zero), V::eq(yVel, zero))))) {
+                    integrateScalar(p, a, i, i + V::WIDTH);
+                    continue;
+                }
+
+                D mult = V::div(minSpeed, speed);
+                xVel   = V::select(slow, V::mul(xVel, mult), xVel);
+                yVel   = V::select(slow, V::mul(yVel, mult), yVel);
+            }
+
+            if constexpr ((F & MAX_SPEED) != 0) {
+                M fast = V::gt(speed, maxSpeed);
+
+                D mult = V::div(maxSpeed, speed);
+                xVel   = V::select(fast, V::mul(xVel, mult), xVel);
+                yVel   = V::select(fast, V::mul(yVel, mult), yVel);
+            }
+        }
+
+        x = V::add(x, V::mul(xVel, frameTime));
+        y = V::add(y, V::mul(yVel, frameTime));
+
+        // |ang| < 2 turns here, where fmod(ang, turn) is exactly one of these (negative angles are mirrored so that -turn yields -0.0 like fmod)
+        ang = V::select(V::ge(ang, turn), V::sub(ang, turn), ang);
+        ang = V::select(V::le(ang, V::neg(turn)), V::neg(V::sub(V::neg(ang), turn)), ang);
+
+        // reflect off the walls: the right/bottom walls only apply if the left/top walls did not
+        D xRight = V::sub(xMax, r);
+        M left   = V::and_(V::le(x, r), V::lt(xVel, zero));
+        M right  = V::andNot(left, V::and_(V::ge(x, xRight), V::gt(xVel, zero)));
+
+        x    = V::select(left, V::max(V::sub(V::add(r, r), x), zero), x);
+        x    = V::select(right, V::min(V::sub(xRight, V::sub(xRight, x)), xRight), x);
+        xVel = V::select(V::or_(left, right), V::neg(xVel), xVel);
+
+        D yBottom = V::sub(yMax, r);
+        M top     = V::and_(V::le(y, r), V::lt(yVel, zero));
+        M bottom  = V::andNot(top, V::and_(V::ge(y, yBottom), V::gt(yVel, zero)));
+
+        y    = V::select(top, V::max(V::sub(V::add(r, r), y), zero), y);
+        y    = V::select(bottom, V::min(V::sub(yBottom, V::sub(yBottom, y)), yBottom), y);
+        yVel = V::select(V::or_(top, bottom), V::neg(yVel), yVel);
+
+        V::store(a.x + i, x);
+        V::store(a.y + i, y);
+        V::store(a.xVel + i, xVel);
+        V::store(a.yVel + i, yVel);
+        V::store(a.ang + i, ang);
+    }
+
+    integrateScalar(p, a, i, end);
+}
+
+template <typename V>
+void integrateSIMD(const IntegrationParams& p, const IntegrationArrays& a, unsigned begin, unsigned end) {
+    static constexpr auto kernels = makeIntegrationTable([](auto f) { return &integrateSIMDFeatures<V, decltype(f)::value>; });
+
+    kernels[p.features](p, a, begin, end);
+}
+
+#endif
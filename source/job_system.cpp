@@ -0,0 +1,221 @@
+#include <algorithm>
+
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#elif defined(_WIN32)
+    #include <windows.h>
+#endif
+
+#include "job_system.h"
+
+// index of the worker that the current thread belongs to; threads that are not owned by the pool act as worker 0
+static thread_local unsigned currentWorker = 0;
+
+// affinity of a thread that called start() before the pool pinned it, restored once it is started without pinning again
+static thread_local bool callerPinned = false;
+#if defined(__linux__)
+static thread_local cpu_set_t callerAffinity;
+#elif defined(_WIN32)
+static thread_local DWORD_PTR callerAffinity = 0;
+#endif
+
+JobSystem::~JobSystem() {
+    stop();
+}
+
+// (re)starts the pool with the given number of workers (including the calling thread); 0 uses one worker per hardware thread
+void JobSystem::start(unsigned threads, bool pinThreads) {
+    stop();
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    pinned   = pinThreads;
+    stopping = false;
+
+    for (unsigned i = 0; i < threads; i++) {
+        workers.emplace_back(std::make_unique<Worker>());
+    }
+
+    // only touch the calling thread when pinning, or to undo a previous start(); otherwise it keeps its affinity (taskset, cgroups)
+    if (pinned) {
+        if (!callerPinned) saveAffinity();
+        pin(0);
+    } else if (callerPinned) {
+        restoreAffinity();
+    }
+
+    for (unsigned i = 1; i < threads; i++) {
+        workers[i]->thread = std::thread(&JobSystem::workerLoop, this, i);
+    }
+
+    sampleTime = Clock::now();
+}
+
+void JobSystem::stop() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    sleepCondition.notify_all();
+
+    for (std::unique_ptr<Worker>& w : workers) {
+        if (w->thread.joinable()) w->thread.join();
+    }
+
+    workers.clear();
+}
+
+unsigned JobSystem::size() const {
+    return workers.size();
+}
+
+void JobSystem::dispatch(unsigned begin, unsigned end, unsigned chunk, void (*run)(void*, unsigned, unsigned), void* context) {
+    if (begin >= end) return;
+
+    chunk = std::max(1u, chunk);
+
+    // not worth waking anyone up for
+    if (workers.size() < 2 || end - begin <= chunk) {
+        run(context, begin, end);
+        return;
+    }
+
+    unsigned chunks = (end - begin + chunk - 1) / chunk;
+    std::atomic<unsigned> remaining(chunks);
+
+    // distribute the chunks round robin, starting with the queue of the calling worker
+    for (unsigned i = 0; i < chunks; i++) {
+        unsigned b = begin + i * chunk;
+        Worker& w  = *workers[(currentWorker + i) % workers.size()];
+
+        // counted before it becomes visible so that queued never drops below the actual number of queued jobs
+        queued++;
+
+        std::lock_guard<std::mutex> lock(w.mutex);
+        w.jobs.push_back({run, context, b, std::min(end, b + chunk), &remaining});
+    }
+
+    // taking the lock guarantees that no worker is between checking its wait predicate and starting to wait
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    sleepCondition.notify_all();
+
+    // help out until every chunk (including the ones stolen by other workers) is done
+    Job job;
+
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        if (findJob(currentWorker, job)) execute(currentWorker, job);
+        else std::this_thread::yield();
+    }
+}
+
+// updates the utilization of every worker once per interval (seconds)
+void JobSystem::sampleUtilization(double interval) {
+    Clock::time_point now = Clock::now();
+    double elapsed        = std::chrono::duration<double>(now - sampleTime).count();
+
+    if (elapsed < interval) return;
+
+    for (std::unique_ptr<Worker>& w : workers) {
+        w->utilization = std::min(1.0, w->busy.exchange(0) / 1e9 / elapsed);
+    }
+
+    sampleTime = now;
+}
+
+void JobSystem::workerLoop(unsigned index) {
+    currentWorker = index;
+
+    if (pinned) pin(index);
+
+    Job job;
+
+    while (true) {
+        if (findJob(index, job)) {
+            execute(index, job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCondition.wait(lock, [this] { return stopping || queued > 0; });
+
+        if (stopping) return;
+    }
+}
+
+// pops from the back of the worker's own queue, otherwise steals from the front of another queue
+bool JobSystem::findJob(unsigned index, Job& job) {
+    {
+        Worker& w = *workers[index];
+        std::lock_guard<std::mutex> lock(w.mutex);
+
+        if (!w.jobs.empty()) {
+            job = w.jobs.back();
+            w.jobs.pop_back();
+            queued--;
+            return true;
+        }
+    }
+
+    for (unsigned i = 1; i < workers.size(); i++) {
+        Worker& w = *workers[(index + i) % workers.size()];
+        std::lock_guard<std::mutex> lock(w.mutex);
+
+        if (!w.jobs.empty()) {
+            job = w.jobs.front();
+            w.jobs.pop_front();
+            queued--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::execute(unsigned index, const Job& job) {
+    Clock::time_point t = Clock::now();
+
+    job.run(job.context, job.begin, job.end);
+
+    workers[index]->busy += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t).count();
+    job.remaining->fetch_sub(1, std::memory_order_release);
+}
+
+// restricts the calling thread to a single core (index modulo core count); not supported on other platforms
+void JobSystem::pin(unsigned index) {
+    unsigned core = index % std::max(1u, std::thread::hardware_concurrency());
+
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#elif defined(_WIN32)
+    if (core < sizeof(DWORD_PTR) * 8) SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core);
+#else
+    (void)core;
+#endif
+}
+
+void JobSystem::saveAffinity() {
+#if defined(__linux__)
+    callerPinned = pthread_getaffinity_np(pthread_self(), sizeof(callerAffinity), &callerAffinity) == 0;
+#elif defined(_WIN32)
+    // there is no getter, setting returns the previous mask
+    DWORD_PTR process = 0, system = 0;
+    GetProcessAffinityMask(GetCurrentProcess(), &process, &system);
+
+    callerAffinity = SetThreadAffinityMask(GetCurrentThread(), process);
+    callerPinned   = callerAffinity != 0;
+#endif
+}
+
+void JobSystem::restoreAffinity() {
+#if defined(__linux__)
+    pthread_setaffinity_np(pthread_self(), sizeof(callerAffinity), &callerAffinity);
+#elif defined(_WIN32)
+    SetThreadAffinityMask(GetCurrentThread(), callerAffinity);
+#endif
+    callerPinned = false;
+}
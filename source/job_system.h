@@ -0,0 +1,82 @@
+#ifndef JOB_SYSTEM_H_GUARD
+#define JOB_SYSTEM_H_GUARD
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+A small work-stealing thread pool.
+
+Worker 0 is the thread that calls parallelFor() (normally the main thread), the remaining workers are threads owned by the pool.
+Every worker has its own job queue: it takes jobs from the back of its own queue and, once that is empty, steals jobs from the front of the other queues.
+
+parallelFor() splits a range into chunks, distributes the chunks over the queues, and then helps execute them until every chunk is done.
+The calling thread is blocked until then, so the function passed to it may safely reference local variables.
+
+Busy time is recorded per worker so that utilization can be displayed.
+*/
+struct JobSystem {
+    using Clock = std::chrono::steady_clock;
+
+    struct Job {
+        void (*run)(void*, unsigned, unsigned);
+        void* context;
+        unsigned begin;
+        unsigned end;
+        std::atomic<unsigned>* remaining;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        std::thread thread;
+
+        std::atomic<long long> busy = 0; // nanoseconds spent running jobs since the last sample
+        double utilization          = 0.0;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    bool pinned = false;
+
+    std::atomic<unsigned> queued = 0;
+    std::atomic<bool> stopping   = false;
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+
+    Clock::time_point sampleTime = Clock::now();
+
+    ~JobSystem();
+
+    void start(unsigned, bool);
+    void stop();
+    unsigned size() const;
+
+    template <typename F>
+    void parallelFor(unsigned begin, unsigned end, unsigned chunk, F&& f) {
+        using Fn = std::remove_reference_t<F>;
+
+        dispatch(
+            begin, end, chunk,
+            [](void* c, unsigned b, unsigned e) { (*static_cast<Fn*>(c))(b, e); },
+            const_cast<void*>(static_cast<const void*>(&f)));
+    }
+
+    void dispatch(unsigned, unsigned, unsigned, void (*)(void*, unsigned, unsigned), void*);
+    void sampleUtilization(double);
+
+    void workerLoop(unsigned);
+    bool findJob(unsigned, Job&);
+    void execute(unsigned, const Job&);
+    static void pin(unsigned);
+    static void saveAffinity();
+    static void restoreAffinity();
+};
+
+#endif
@@ -1,6 +1,9 @@
 #include <iostream>
 #include <memory>
 #include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
 
 // https://www.boost.org/doc/libs/1_79_0/libs/filesystem/doc/tutorial.html
 #include <boost/filesystem.hpp>
@@ -16,7 +19,17 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "rng.h"
+#include "window.h"
 #include "star.h"
+#include "star_system.h"
+#include "star_renderer.h"
+#include "simulation.h"
+#include "job_system.h"
+#include "offscreen_context.h"
+#include "frame_capture.h"
+#include "render_queue.h"
+#include "shader.h"
 
 const int SCREEN_SIZE_X       = 1920;
 const int SCREEN_SIZE_Y       = 1080;
@@ -33,10 +46,17 @@ const int MSAA_SAMPLES = 4;
 // This also prevents long program pauses (== high frameTime values) from causing excessively incorrect behavior (e.g. stars teleporting).
 // The drawback is slowdown when FPS falls below 30.
 const double FRAME_TIME_MAX = 1.0 / 30.0;
-const int MAX_STARS         = 8000;
+const int DEFAULT_MAX_STARS = 8000;
+
+// names of the StarMeshes LODs in the statistics
+const char* const LOD_NAMES[] = {"Detailed", "Reduced", "Polygon", "Point"};
+
+// seconds between utilization samples of the job system's workers
+const double UTILIZATION_INTERVAL = 0.5;
 
 const std::string PATH_SYSTEM = "./config/system/";
 const std::string PATH_USER   = "./config/user/";
+const std::string PATH_CACHE  = "./config/cache/"; // linked shader program binaries (see shader.h)
 const std::string EXT_DEFAULT = ".cfg";
 
 // https://docs.gl/gl4/glBlendFunc
@@ -88,20 +108,61 @@ const char* const glBlendFunc_factor_name[] = {
 
 #undef GET_NAME
 
-// contains all stars that appear on the main window
-static std::vector<std::unique_ptr<Star>> stars;
+// global struct: used to generate random values
+RNG rng;
+// global struct: contains various user-controlled settings
+Config cfg;
+// global struct: contains properties GLFW and ImGui windows
+Windows win;
+// global var: contains frame time used as a multiplier to make stars appear to move at the same speed regardless of FPS
+double frameTime = 0.0;
+
+// contains all stars that appear on the main window, and their collision state
+static Simulation sim;
+// draws the stars of sim
+static StarRenderer starRenderer;
+
+// draw packets of the main window and of the config window (preview and ImGui), executed once per frame of their window
+static RenderQueue mainQueue;
+static RenderQueue cfgQueue;
 
 // contains stars used in the preview of the config window
 static struct PreviewStars {
-    std::unique_ptr<Star> min;
-    std::unique_ptr<Star> avg;
-    std::unique_ptr<Star> max;
-
-    void forceVisible() const {
-        if (min && avg && max) {
-            min->color->assign(0.0f, 1.0f, 1.0f, 1.0f);
-            avg->color->assign(1.0f, 1.0f, 0.0f, 1.0f);
-            max->color->assign(1.0f, 0.0f, 1.0f, 1.0f);
+    enum { MIN, AVG, MAX };
+
+    StarSystem stars;
+    StarRenderer renderer;
+
+    // size of the preview frame buffer
+    int w = 0;
+    int h = 0;
+
+    // render queue callback: the preview stars are drawn into the frame buffer, which then gets displayed in ImGui as a texture
+    static void bindFrameBuffer(void* context) {
+        PreviewStars& p = *static_cast<PreviewStars*>(context);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, win.cfg.frameBuffer);
+        glViewport(0, 0, p.w, p.h); // adjust frame buffer width/height based on star sizes
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    void generate() {
+        renderer.clear();
+        stars.clear();
+
+        for (Enum::Star::GenType t : {Enum::Star::GenType::MIN, Enum::Star::GenType::AVG, Enum::Star::GenType::MAX}) {
+            Star s(t, cfg, rng, win.main.w, win.main.h);
+            stars.add(s);
+            renderer.add(stars, stars.size() - 1);
+        }
+    }
+
+    void forceVisible() {
+        if (stars.size() == 3) {
+            stars.color[MIN].assign(0.0f, 1.0f, 1.0f, 1.0f);
+            stars.color[AVG].assign(1.0f, 1.0f, 0.0f, 1.0f);
+            stars.color[MAX].assign(1.0f, 0.0f, 1.0f, 1.0f);
         }
     }
 } pre;
@@ -118,39 +179,74 @@ static struct MainWinTitle {
     const int fpsR   = fpsL + 3;
 } mainWinTitle;
 
-// global struct: used to generate random values
-RNG rng;
-// global struct: contains various user-controlled settings
-Config cfg;
-// global struct: contains properties GLFW and ImGui windows
-Windows win;
-// global var: contains frame time used as a multiplier to make stars appear to move at the same speed regardless of FPS
-double frameTime = 0.0;
+// thread pool used to split frame stages across all cores
+static JobSystem jobs;
+
+// upper limit of the number of stars (--max-stars N); offscreen runs with more stars (--stars N) raise it
+static int maxStars = DEFAULT_MAX_STARS;
+
+// time at which main() started; used to report the time to the first frame
+static std::chrono::steady_clock::time_point startTime;
+
+// offscreen mode (--offscreen): the main window is replaced by an offscreen context, the config window is not created (its preview is drawn into a frame buffer of the offscreen context), and the program exits after a number of frames
+static struct Offscreen {
+    bool requested = false;
+    int w          = 0;
+    int h          = 0;
+    int frames     = 600;
+    int stars      = 1000;
+
+    OffscreenContext context;
+} offscreen;
+
+// frame capture (--capture PATH): the frames of the main window (or the offscreen context) are recorded into a video stream
+static struct Capture {
+    std::string path;
+    FrameCapture::Format format = FrameCapture::Y4M;
+
+    FrameCapture recorder;
+} capture;
 
 // main loop
 
 void execute();
+void executeOffscreen();
+void renderImGui(void*);
+void printTimeToFirstFrame();
+bool parseArguments(int, char**);
+void startCapture();
+void stopCapture();
 
 // Star
 
 void addRemoveStars(int);
 void regenStars();
 void updateStars();
+void applyThreadConfig();
 
 // ImGui creation
 
 void createGUI();
+void displayThreads();
 bool displayGenerationParameters();
 void displayPreview(bool);
+void submitPreview();
 
 // GLFW window create/destruction
 
 void createMainWin();
 void destroyMainWin();
+void createOffscreenContext();
+void destroyOffscreenContext();
+void initMainContext();
+void makeMainContextCurrent();
+void makeContextCurrent(GLFWwindow*);
 
 void createCfgWin();
 void destroyCfgWin();
 void createDestroyCfgWin();
+void createPreviewFrameBuffer();
+void destroyPreviewFrameBuffer();
 
 // GLFW window utility
 
@@ -175,23 +271,49 @@ void cfgWinCloseCallback(GLFWwindow*);
 
 int cfgNameImGuiInputTextFilter(ImGuiInputTextCallbackData*);
 
-int main() {
-    stars.reserve(MAX_STARS);
+int main(int argc, char** argv) {
+    startTime = std::chrono::steady_clock::now();
+
+    if (!parseArguments(argc, argv)) return 1;
+
+    sim.stars.reserve(maxStars);
+    starRenderer.reserve(maxStars);
 
     glfwSetErrorCallback(errorCallback);
 
-    if (!glfwInit()) {
+    if (!offscreen.requested && !glfwInit()) {
         std::cerr << "glfwInit(): failed\n";
         exit(1);
     }
 
     cfg.load(PATH_SYSTEM, "data", EXT_DEFAULT);
 
-    createMainWin();
-    createCfgWin();
+    ProgramRegistry::cacheDirectory = PATH_CACHE;
+
+    if (offscreen.requested) {
+        createOffscreenContext();
+    } else {
+        createMainWin();
+        createCfgWin();
+    }
+
+    applyThreadConfig();
+    startCapture();
+
+    // main program loop
+    if (offscreen.requested) executeOffscreen();
+    else execute();
 
-    execute();                     // main program loop
-    addRemoveStars(-stars.size()); // correctly free the memory for all the existing stars before shutdown
+    stopCapture();
+    addRemoveStars(-sim.stars.size()); // correctly free the memory for all the existing stars before shutdown
+
+    jobs.stop();
+
+    // batch runs leave the config alone
+    if (offscreen.requested) {
+        destroyOffscreenContext();
+        return 0;
+    }
 
     destroyCfgWin();
     destroyMainWin();
@@ -201,8 +323,54 @@ int main() {
     cfg.save(PATH_SYSTEM, "data", EXT_DEFAULT);
 }
 
+// stars [--max-stars N] [--offscreen WIDTHxHEIGHT [--frames N] [--stars N]] [--capture PATH [--capture-format y4m|raw]]
+bool parseArguments(int argc, char** argv) {
+    auto parse = [](const char* first, const char* last, int& value) {
+        std::from_chars_result r = std::from_chars(first, last, value);
+        return r.ec == std::errc() && r.ptr == last && value > 0;
+    };
+
+    bool valid = true;
+
+    for (int i = 1; i < argc && valid; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        const char* end   = value ? value + strlen(value) : nullptr;
+
+        if (!value) {
+            valid = false;
+        } else if (strcmp(argv[i], "--offscreen") == 0) {
+            const char* x       = std::find(value, end, 'x');
+            offscreen.requested = true;
+            valid               = x != end && parse(value, x, offscreen.w) && parse(x + 1, end, offscreen.h);
+        } else if (strcmp(argv[i], "--frames") == 0) {
+            valid = parse(value, end, offscreen.frames);
+        } else if (strcmp(argv[i], "--stars") == 0) {
+            valid = parse(value, end, offscreen.stars);
+        } else if (strcmp(argv[i], "--max-stars") == 0) {
+            valid = parse(value, end, maxStars);
+        } else if (strcmp(argv[i], "--capture") == 0) {
+            capture.path = value;
+        } else if (strcmp(argv[i], "--capture-format") == 0) {
+            if (strcmp(value, "y4m") == 0) capture.format = FrameCapture::Y4M;
+            else if (strcmp(value, "raw") == 0) capture.format = FrameCapture::RAW;
+            else valid = false;
+        } else {
+            valid = false;
+        }
+
+        i++;
+    }
+
+    if (!valid) std::cerr << "usage: " << argv[0] << " [--max-stars N] [--offscreen WIDTHxHEIGHT [--frames N] [--stars N]] [--capture PATH [--capture-format y4m|raw]]\n";
+
+    if (offscreen.requested) maxStars = std::max(maxStars, offscreen.stars);
+
+    return valid;
+}
+
 void execute() {
     std::chrono::steady_clock::time_point updateTime = std::chrono::steady_clock::now();
+    bool firstFrame                                  = true;
 
     while (!glfwWindowShouldClose(win.main.glfw)) {
         std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
@@ -217,8 +385,7 @@ void execute() {
 
             glfwPollEvents();
 
-            glfwMakeContextCurrent(NULL);
-            glfwMakeContextCurrent(win.main.glfw);
+            makeMainContextCurrent();
 
             glfwGetFramebufferSize(win.main.glfw, &win.main.w, &win.main.h);
             glViewport(0, 0, win.main.w, win.main.h);
@@ -232,15 +399,24 @@ void execute() {
 
             frameTime = std::min(frameTime, FRAME_TIME_MAX);
 
+            // the SDF render mode anti-aliases analytically, so MSAA would only cost fill rate
+            if (cfg.renderMode == Enum::Config::RenderMode::SDF) glDisable(GL_MULTISAMPLE);
+            else glEnable(GL_MULTISAMPLE);
+
             // update and draw in OpenGL
-            Star::prepareProjection(win.main.w, win.main.h);
+            StarRenderer::prepareProjection(win.main.w, win.main.h);
+            applyThreadConfig();
             updateStars();
+            mainQueue.execute();
+
+            jobs.sampleUtilization(UTILIZATION_INTERVAL);
+
+            capture.recorder.capture(0, win.main.w, win.main.h); // the back buffer, before it is swapped
 
             glfwSwapBuffers(win.main.glfw);
 
             if (win.cfg.exists) {
-                glfwMakeContextCurrent(NULL);
-                glfwMakeContextCurrent(win.cfg.glfw);
+                makeContextCurrent(win.cfg.glfw);
 
                 glfwGetFramebufferSize(win.cfg.glfw, &win.cfg.w, &win.cfg.h);
                 glViewport(0, 0, win.cfg.w, win.cfg.h);
@@ -261,40 +437,172 @@ void execute() {
                 createGUI();
 
                 ImGui::Render();
-                ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+                cfgQueue.submit(RenderQueue::OVERLAY, 0, renderImGui, nullptr);
+                cfgQueue.execute();
 
                 glfwSwapBuffers(win.cfg.glfw);
             }
+
+            if (firstFrame) {
+                printTimeToFirstFrame();
+                firstFrame = false;
+            }
+        }
+    }
+}
+
+// draws a fixed number of frames into the offscreen context and reports the average time of each stage of a frame
+void executeOffscreen() {
+    using Clock = std::chrono::steady_clock;
+
+    // a fixed frame time, so that batch runs do not depend on how fast the frames are drawn
+    frameTime = std::min(1.0 / (double)cfg.targetFPS, FRAME_TIME_MAX);
+
+    addRemoveStars(offscreen.stars);
+
+    std::chrono::duration<double, std::milli> update(0.0), submit(0.0), preview(0.0), finish(0.0);
+
+    for (int frame = 0; frame < offscreen.frames; frame++) {
+        Clock::time_point t0 = Clock::now();
+
+        if (cfg.clear) {
+            glClearColor(cfg.backgroundColor.r, cfg.backgroundColor.g, cfg.backgroundColor.b, cfg.backgroundColor.a);
+            glClear(GL_COLOR_BUFFER_BIT);
         }
+
+        if (cfg.renderMode == Enum::Config::RenderMode::SDF) glDisable(GL_MULTISAMPLE);
+        else glEnable(GL_MULTISAMPLE);
+
+        StarRenderer::prepareProjection(win.main.w, win.main.h);
+        applyThreadConfig();
+        jobs.sampleUtilization(UTILIZATION_INTERVAL);
+        updateStars();
+
+        Clock::time_point t1 = Clock::now();
+
+        mainQueue.execute();
+
+        Clock::time_point t2 = Clock::now();
+
+        offscreen.context.resolve();
+        capture.recorder.capture(offscreen.context.resolveFrameBuffer, win.main.w, win.main.h);
+
+        Clock::time_point t3 = Clock::now();
+
+        // the preview of the config window, through the same queue as in the windowed program; it leaves its frame buffer bound
+        submitPreview();
+        cfgQueue.execute();
+
+        glBindFramebuffer(GL_FRAMEBUFFER, offscreen.context.frameBuffer);
+        glViewport(0, 0, win.main.w, win.main.h);
+
+        Clock::time_point t4 = Clock::now();
+
+        glFinish(); // what the frame costs the GPU (or llvmpipe) beyond its submission
+
+        Clock::time_point t5 = Clock::now();
+
+        update += t1 - t0;
+        submit += t2 - t1;
+        preview += t4 - t3;
+        finish += (t3 - t2) + (t5 - t4);
+
+        if (frame == 0) printTimeToFirstFrame();
     }
+
+    double n = std::max(offscreen.frames, 1);
+
+    printf("offscreen: %d frames, %u stars, %dx%d, %s\n", offscreen.frames, sim.stars.size(), win.main.w, win.main.h, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    printf("per frame: update %.3f ms, submit %.3f ms, preview %.3f ms, finish %.3f ms (last frame: %u packets, %u state changes, %u skipped)\n",
+           update.count() / n, submit.count() / n, preview.count() / n, finish.count() / n, mainQueue.stats.packets, mainQueue.stats.stateChanges, mainQueue.stats.skipped);
+
+    printf("workers:");
+    for (unsigned i = 0; i < jobs.size(); i++) printf(" %.0f%%", jobs.workers[i]->utilization * 100.0);
+    printf("\n");
+
+    // of the last frame, only counted in the mesh render mode
+    const StarMeshes::LODStats& l = starRenderer.renderer.meshes.lodStats;
+    unsigned drawn               = 0;
+
+    printf("LOD (stars/primitives):");
+
+    for (unsigned i = 0; i < StarMeshes::LODS; i++) {
+        printf(" %s %u/%u", LOD_NAMES[i], l.stars[i], l.primitives[i]);
+        drawn += l.primitives[i];
+    }
+
+    printf(", %u of %u primitives at full detail (%.1f%%)\n", drawn, l.fullPrimitives, l.fullPrimitives ? drawn * 100.0 / l.fullPrimitives : 100.0);
+
+    // flushes the frames still in flight so that the counters are final
+    stopCapture();
+}
+
+// the stream has the size of the main framebuffer when the program starts
+void startCapture() {
+    if (capture.path.empty()) return;
+
+    makeMainContextCurrent();
+
+    if (!offscreen.requested) glfwGetFramebufferSize(win.main.glfw, &win.main.w, &win.main.h);
+
+    if (!capture.recorder.start(capture.path, capture.format, win.main.w, win.main.h, cfg.targetFPS)) exit(1);
+}
+
+void stopCapture() {
+    if (!capture.recorder.active) return;
+
+    makeMainContextCurrent();
+    capture.recorder.stop();
+
+    FrameCapture::Stats s = capture.recorder.snapshot();
+
+    printf("capture: %u frames written, %u dropped (GPU %u, writer %u, size %u), latency %.1f ms average, %.1f ms max\n",
+           s.written, s.droppedGPU + s.droppedWriter + s.droppedSize, s.droppedGPU, s.droppedWriter, s.droppedSize, s.latency, s.maxLatency);
+}
+
+// render queue callback: draws the ImGui UI into the config window
+void renderImGui(void*) {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, win.cfg.w, win.cfg.h);
+
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+}
+
+// startup time including window creation, program compilation (or cache loads), and the first update and draw
+void printTimeToFirstFrame() {
+    std::chrono::duration<double, std::milli> t = std::chrono::steady_clock::now() - startTime;
+
+    printf("time to first frame: %.1f ms (program cache: %u hits, %u misses)\n", t.count(), ProgramRegistry::cacheHits, ProgramRegistry::cacheMisses);
 }
 
 void addRemoveStars(int n) {
     if (n == 0) return;
 
-    glfwMakeContextCurrent(NULL);
-    glfwMakeContextCurrent(win.main.glfw);
+    makeMainContextCurrent();
 
     if (n > 0) {
-        n = std::min(n, MAX_STARS - static_cast<int>(stars.size()));
+        n = std::min(n, maxStars - static_cast<int>(sim.stars.size()));
 
         for (; n > 0; n--) {
-            stars.emplace_back(std::make_unique<Star>(Enum::Star::GenType::RNG));
+            Star s(Enum::Star::GenType::RNG, cfg, rng, win.main.w, win.main.h);
+            sim.add(s);
+            starRenderer.add(sim.stars, sim.stars.size() - 1);
         }
     } else if (n < 0) {
-        for (; !stars.empty() && n < 0; n++) {
-            stars.pop_back();
+        for (; !sim.stars.empty() && n < 0; n++) {
+            starRenderer.removeLast();
+            sim.removeLast();
         }
     }
 }
 
 void regenStars() {
-    if (stars.empty()) return;
+    if (sim.stars.empty()) return;
 
-    glfwMakeContextCurrent(NULL);
-    glfwMakeContextCurrent(win.main.glfw);
+    makeMainContextCurrent();
 
-    int n = stars.size();
+    int n = sim.stars.size();
 
     addRemoveStars(-n);
     addRemoveStars(n);
@@ -304,29 +612,18 @@ void regenStars() {
 }
 
 void updateStars() {
-    if (cfg.collisions) {
-        for (const std::unique_ptr<Star>& s : stars) {
-            s->update();
-            s->notCollided = true;
-        }
-        for (unsigned i = 0; i < stars.size(); i++) {
-            if (stars[i]->notCollided) {
-                for (unsigned j = i + 1; j < stars.size(); j++) {
-                    if (stars[j]->notCollided && Star::collision(*stars[i], *stars[j])) {
-                        stars[j]->notCollided = false;
-                        break;
-                    }
-                }
-            }
-            stars[i]->draw();
-        }
-    } else {
-        for (const std::unique_ptr<Star>& s : stars) {
-            s->update();
-            s->draw();
-        }
-    }
-    Star::updateIndexUniformRGBColors();
+    sim.step(jobs, cfg, frameTime, win.main.w, win.main.h);
+
+    starRenderer.draw(sim.stars, mainQueue, RenderQueue::STARS, {(GLenum)glBlendFunc_factor[cfg.srcBlendMode], (GLenum)glBlendFunc_factor[cfg.dstBlendMode]});
+
+    StarRenderer::updateUniformPhase();
+}
+
+// restarts the job system if its thread settings were changed (via the GUI or by loading/resetting the config)
+void applyThreadConfig() {
+    unsigned threads = cfg.threads > 0 ? cfg.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    if (threads != jobs.size() || cfg.pinThreads != jobs.pinned) jobs.start(threads, cfg.pinThreads);
 }
 
 // ImGui creation
@@ -362,36 +659,27 @@ void createGUI() {
 
             ImGui::SameLine();
             if (ImGui::Button("Clear"))
-                amount += -stars.size();
+                amount += -sim.stars.size();
 
             if (amount != 0) {
                 addRemoveStars(amount);
 
-                glfwMakeContextCurrent(NULL);
-                glfwMakeContextCurrent(win.cfg.glfw);
+                makeContextCurrent(win.cfg.glfw);
             }
         }
         if (ImGui::CollapsingHeader("Effects")) {
             ImGui::Checkbox("Clear Screen", &cfg.clear);
 
-            bool blendModeAdjusted = false;
-
             // https://docs.gl/gl4/glBlendFunc
+            // the blend mode is part of every star draw packet, so the main window's render queue applies changes on its own
             ImGui::Separator();
-            blendModeAdjusted |= ImGui::Combo("Src Blend Mode", &cfg.srcBlendMode, glBlendFunc_factor_name, IM_ARRAYSIZE(glBlendFunc_factor_name));
+            ImGui::Combo("Src Blend Mode", &cfg.srcBlendMode, glBlendFunc_factor_name, IM_ARRAYSIZE(glBlendFunc_factor_name));
 
             ImGui::Separator();
-            blendModeAdjusted |= ImGui::Combo("Dst Blend Mode", &cfg.dstBlendMode, glBlendFunc_factor_name, IM_ARRAYSIZE(glBlendFunc_factor_name));
-
-            if (blendModeAdjusted) {
-                glfwMakeContextCurrent(NULL);
-                glfwMakeContextCurrent(win.main.glfw);
+            ImGui::Combo("Dst Blend Mode", &cfg.dstBlendMode, glBlendFunc_factor_name, IM_ARRAYSIZE(glBlendFunc_factor_name));
 
-                glBlendFunc(glBlendFunc_factor[cfg.srcBlendMode], glBlendFunc_factor[cfg.dstBlendMode]);
-
-                glfwMakeContextCurrent(NULL);
-                glfwMakeContextCurrent(win.cfg.glfw);
-            }
+            ImGui::Separator();
+            ImGui::Combo("Render Mode", &cfg.renderMode, "Mesh (MSAA)\0SDF (Analytic AA)\0");
 
             ImGui::Separator();
             ImGui::Combo("Color Mode", &cfg.colorMode, "Default\0Random\0Uniform\0Consistent\0");
@@ -403,6 +691,26 @@ void createGUI() {
         if (ImGui::CollapsingHeader("Physics")) {
             ImGui::Checkbox("Collisions", &cfg.collisions);
 
+            ImGui::SameLine();
+            ImGui::Checkbox("Parallel", &cfg.parallelCollisions);
+
+            ImGui::SameLine();
+            ImGui::Combo("Broadphase", &cfg.broadphase, "Brute Force\0Spatial Grid\0Sweep And Prune\0AABB Tree\0");
+
+            ImGui::DragFloat("##verletSkin", &cfg.verletSkin, 100.0f / S, 0.0f, 100.0f, FF, SF);
+
+            ImGui::SameLine();
+            ImGui::Checkbox("Verlet Lists", &cfg.verletLists);
+
+            if (cfg.verletLists) {
+                ImGui::Text("Rebuilds: %u / %u frames (%.1f%%), %.1f candidates per star",
+                            sim.verlet.rebuilds, sim.verlet.frames, sim.verlet.rebuildRate() * 100.0, sim.verlet.averageLength());
+
+                ImGui::SameLine();
+                if (ImGui::Button("Reset##verletCounters"))
+                    sim.verlet.resetCounters();
+            }
+
             ImGui::Separator();
             ImGui::DragFloat("##gravityVal", &cfg.gravityVal, 100.0f / S, -100.0f, 100.0f, FF, SF);
 
@@ -423,12 +731,14 @@ void createGUI() {
             ImGui::SameLine();
             ImGui::Checkbox("Max", &cfg.maxSpeed);
         }
+        if (ImGui::CollapsingHeader("Threads")) {
+            displayThreads();
+        }
         if (ImGui::CollapsingHeader("Parameters")) {
             if (ImGui::Button("Apply")) {
                 regenStars();
 
-                glfwMakeContextCurrent(NULL);
-                glfwMakeContextCurrent(win.cfg.glfw);
+                makeContextCurrent(win.cfg.glfw);
             }
 
             ImGui::SameLine();
@@ -498,8 +808,7 @@ void createGUI() {
                         regenStars();
                         reloadPreview |= true;
 
-                        glfwMakeContextCurrent(NULL);
-                        glfwMakeContextCurrent(win.cfg.glfw);
+                        makeContextCurrent(win.cfg.glfw);
                     }
 
                     ImGui::SameLine(0.0f, 32.0f);
@@ -523,8 +832,7 @@ void createGUI() {
                 regenStars();
                 reloadPreview |= true;
 
-                glfwMakeContextCurrent(NULL);
-                glfwMakeContextCurrent(win.cfg.glfw);
+                makeContextCurrent(win.cfg.glfw);
             }
 
             ImGui::SameLine();
@@ -540,6 +848,49 @@ void createGUI() {
     ImGui::End();
 }
 
+void displayThreads() {
+    static const ImGuiSliderFlags SF = ImGuiSliderFlags_NoRoundToFormat |
+                                       ImGuiSliderFlags_AlwaysClamp;
+
+    // 0 == one worker per hardware thread; changes are applied by applyThreadConfig()
+    ImGui::SliderInt("Threads", &cfg.threads, 0, std::thread::hardware_concurrency(), "%d", SF);
+
+    ImGui::SameLine();
+    ImGui::Checkbox("Pin", &cfg.pinThreads);
+
+    ImGui::Text("Integration kernel: %s", StarSystem::integration.name);
+    ImGui::Text("Narrowphase kernel: %s", ParallelCollisions::kernels.name);
+
+    const RenderQueue::Stats& q = mainQueue.stats;
+    ImGui::Text("Render queue: %u packets, %u state changes, %u skipped", q.packets, q.stateChanges, q.skipped);
+
+    if (capture.recorder.active) {
+        FrameCapture::Stats c = capture.recorder.snapshot();
+        ImGui::Text("Capture: %u written, %u dropped (GPU %u, writer %u, size %u), latency %.1f ms (max %.1f ms)",
+                    c.written, c.droppedGPU + c.droppedWriter + c.droppedSize, c.droppedGPU, c.droppedWriter, c.droppedSize, c.latency, c.maxLatency);
+    }
+
+    // only counted in the mesh render mode
+    const StarMeshes::LODStats& l = starRenderer.renderer.meshes.lodStats;
+    unsigned drawn               = 0;
+
+    for (unsigned i = 0; i < StarMeshes::LODS; i++) {
+        ImGui::Text("LOD %s: %u stars, %u primitives", LOD_NAMES[i], l.stars[i], l.primitives[i]);
+        drawn += l.primitives[i];
+    }
+
+    ImGui::Text("Primitives: %u of %u at full detail (%.1f%%)", drawn, l.fullPrimitives, l.fullPrimitives ? drawn * 100.0 / l.fullPrimitives : 100.0);
+
+    ImGui::Separator();
+
+    for (unsigned i = 0; i < jobs.size(); i++) {
+        char label[32];
+        snprintf(label, sizeof(label), "worker %u: %.0f%%", i, jobs.workers[i]->utilization * 100.0);
+
+        ImGui::ProgressBar(jobs.workers[i]->utilization, ImVec2(-1.0f, 0.0f), label);
+    }
+}
+
 bool displayGenerationParameters() {
     static const ImGuiSliderFlags SF = ImGuiSliderFlags_NoRoundToFormat |
                                        ImGuiSliderFlags_AlwaysClamp;
@@ -612,41 +963,50 @@ bool displayGenerationParameters() {
 void displayPreview(bool adjusted) {
     // if any settings were changed in the last frame, construct new preview stars so that those settings are applied
     if (adjusted) {
-        pre.min = std::make_unique<Star>(Enum::Star::GenType::MIN);
-        pre.avg = std::make_unique<Star>(Enum::Star::GenType::AVG);
-        pre.max = std::make_unique<Star>(Enum::Star::GenType::MAX);
+        pre.generate();
 
         if (cfg.forceVisiblePreview) pre.forceVisible();
     }
 
-    // spacing, width, height
-    int s = 10, w = 0, h = 0;
+    submitPreview();
 
-    // expand/contract the preview size based on the size of the stars (if the preview window exceeds the size of the config window, then scrolling can be used)
+    ImGui::Separator();
+    ImGui::GetWindowDrawList()->AddImage((void*)win.cfg.texture,
+                                         ImVec2(ImGui::GetCursorPosX() - ImGui::GetScrollX(), ImGui::GetCursorPosY() - ImGui::GetScrollY()),
+                                         ImVec2(ImGui::GetCursorPosX() + pre.w - ImGui::GetScrollX(), ImGui::GetCursorPosY() + pre.h - ImGui::GetScrollY()),
+                                         ImVec2(0, 1),
+                                         ImVec2(1, 0));
 
-    w += s;
+    // Above image doesn't behave like an ImGui element, so create a dummy rectangular element that is the dimensions of the image.
+    // This fixes scrolling: without the dummy, you would not be able to scroll the image on/off screen.
+    ImGui::Dummy(ImVec2(pre.w, pre.h));
+}
 
-    w += pre.min->iRadius + pre.min->oRadius;
-    pre.min->x = w;
-    w += pre.min->iRadius + pre.min->oRadius;
+// places the preview stars next to each other, sizes the preview frame buffer to fit them, and submits their draw to the config window's queue
+void submitPreview() {
+    // spacing, width, height
+    int s = 10, w = 0, h = 0;
 
-    w += s;
+    // expand/contract the preview size based on the size of the stars (if the preview window exceeds the size of the config window, then scrolling can be used)
 
-    w += pre.avg->iRadius + pre.avg->oRadius;
-    pre.avg->x = w;
-    w += pre.avg->iRadius + pre.avg->oRadius;
+    StarSystem& p = pre.stars;
 
-    w += s;
+    // min, avg, max from left to right
+    for (unsigned i = 0; i < p.size(); i++) {
+        w += s;
 
-    w += pre.max->iRadius + pre.max->oRadius;
-    pre.max->x = w;
-    w += pre.max->iRadius + pre.max->oRadius;
+        w += p.iRadius[i] + p.oRadius[i];
+        p.x[i] = w;
+        w += p.iRadius[i] + p.oRadius[i];
+    }
 
     w += s;
 
-    h = s + 2 * pre.max->iRadius + 2 * pre.max->oRadius + s;
+    h = s + 2 * p.iRadius[PreviewStars::MAX] + 2 * p.oRadius[PreviewStars::MAX] + s;
 
-    pre.min->y = pre.avg->y = pre.max->y = h / 2;
+    for (unsigned i = 0; i < p.size(); i++) {
+        p.y[i] = h / 2;
+    }
 
     // clang-format off
     glBindTexture(GL_TEXTURE_2D, win.cfg.texture);
@@ -658,30 +1018,16 @@ void displayPreview(bool adjusted) {
     //     glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, MSAA_SAMPLES, GL_RGBA, w, h, GL_TRUE);
     // glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
 
-    glBindFramebuffer(GL_FRAMEBUFFER, win.cfg.frameBuffer);
-        glViewport(0, 0, w, h); // adjust frame buffer width/height based on star sizes
-        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        Star::prepareProjection(w, h);
-
-        // following draws into the frame buffer's data which then gets displayed in ImGui as a texture
-        pre.min->draw();
-        pre.avg->draw();
-        pre.max->draw();
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
     // clang-format on
 
-    ImGui::Separator();
-    ImGui::GetWindowDrawList()->AddImage((void*)win.cfg.texture,
-                                         ImVec2(ImGui::GetCursorPosX() - ImGui::GetScrollX(), ImGui::GetCursorPosY() - ImGui::GetScrollY()),
-                                         ImVec2(ImGui::GetCursorPosX() + w - ImGui::GetScrollX(), ImGui::GetCursorPosY() + h - ImGui::GetScrollY()),
-                                         ImVec2(0, 1),
-                                         ImVec2(1, 0));
+    pre.w = w;
+    pre.h = h;
 
-    // Above image doesn't behave like an ImGui element, so create a dummy rectangular element that is the dimensions of the image.
-    // This fixes scrolling: without the dummy, you would not be able to scroll the image on/off screen.
-    ImGui::Dummy(ImVec2(w, h));
+    StarRenderer::prepareProjection(w, h);
+
+    // drawn when the config window's queue is executed: after the frame buffer is bound, before the ImGui overlay that displays it
+    cfgQueue.submit(RenderQueue::PREVIEW, 0, PreviewStars::bindFrameBuffer, &pre);
+    pre.renderer.draw(p, cfgQueue, RenderQueue::PREVIEW, {GL_ONE, GL_ZERO});
 }
 
 // window creation/destruction
@@ -703,16 +1049,13 @@ void createMainWin() {
 
     glfwSetWindowPos(win.main.glfw, win.main.x, win.main.y);
 
-    glfwMakeContextCurrent(win.main.glfw);
+    makeContextCurrent(win.main.glfw);
     if (!gladLoadGL(glfwGetProcAddress)) {
         std::cerr << "gladLoadGL(glfwGetProcAddress): failed\n";
         exit(1);
     }
 
-    glEnable(GL_BLEND);
-    glBlendFunc(glBlendFunc_factor[cfg.srcBlendMode], glBlendFunc_factor[cfg.dstBlendMode]);
-
-    glEnable(GL_MULTISAMPLE);
+    initMainContext();
 
     glfwSetKeyCallback(win.main.glfw, mainWinKeyCallback);
     glfwSetWindowPosCallback(win.main.glfw, mainWinPosCallback);
@@ -721,6 +1064,63 @@ void createMainWin() {
     win.main.exists = true;
 }
 
+// replaces the main window in offscreen mode; its context stays current
+void createOffscreenContext() {
+    if (!offscreen.context.create(offscreen.w, offscreen.h, GLFW_CONTEXT_VER_MAJOR, GLFW_CONTEXT_VER_MINOR, MSAA_SAMPLES)) exit(1);
+
+    // GLFW is not initialized in offscreen mode, so the programs are keyed by the EGL context
+    ProgramRegistry::current = offscreen.context.context;
+
+    win.main.w = offscreen.w;
+    win.main.h = offscreen.h;
+
+    initMainContext();
+
+    // the offscreen frame buffer stays bound except while the preview is drawn
+    createPreviewFrameBuffer();
+    glBindFramebuffer(GL_FRAMEBUFFER, offscreen.context.frameBuffer);
+
+    pre.generate();
+
+    if (cfg.forceVisiblePreview) pre.forceVisible();
+}
+
+void destroyOffscreenContext() {
+    destroyPreviewFrameBuffer();
+
+    pre.renderer.clear();
+    pre.stars.clear();
+
+    offscreen.context.destroy();
+    ProgramRegistry::current = nullptr;
+}
+
+// GL state of the context that draws the main stars
+void initMainContext() {
+    glEnable(GL_BLEND);
+    glBlendFunc(glBlendFunc_factor[cfg.srcBlendMode], glBlendFunc_factor[cfg.dstBlendMode]);
+
+    // the POINT LOD of the star meshes sets its size in the vertex shader
+    glEnable(GL_PROGRAM_POINT_SIZE);
+
+    glEnable(GL_MULTISAMPLE);
+}
+
+void makeMainContextCurrent() {
+    // the offscreen context is always current
+    if (offscreen.requested) return;
+
+    makeContextCurrent(win.main.glfw);
+}
+
+// every window context is made current here, so that the program registry knows which context it creates programs in (see ProgramRegistry::current)
+void makeContextCurrent(GLFWwindow* window) {
+    glfwMakeContextCurrent(NULL);
+    glfwMakeContextCurrent(window);
+
+    ProgramRegistry::current = window;
+}
+
 void destroyMainWin() {
     if (!win.main.exists) return;
 
@@ -748,8 +1148,7 @@ void createCfgWin() {
 
     glfwSetWindowPos(win.cfg.glfw, win.cfg.x, win.cfg.y);
 
-    glfwMakeContextCurrent(NULL);
-    glfwMakeContextCurrent(win.cfg.glfw);
+    makeContextCurrent(win.cfg.glfw);
     if (!gladLoadGL(glfwGetProcAddress)) {
         std::cerr << "gladLoadGL(glfwGetProcAddress) failed\n";
         exit(1);
@@ -757,33 +1156,10 @@ void createCfgWin() {
 
     // glEnable(GL_MULTISAMPLE);
 
-    glGenFramebuffers(1, &win.cfg.frameBuffer);
-    glGenTextures(1, &win.cfg.texture);
+    // the preview stars are drawn like the main window's (POINT LOD)
+    glEnable(GL_PROGRAM_POINT_SIZE);
 
-    // clang-format off
-    // This texture is used for the preview window.
-    // ImGui requires a texture to be able to add a custom image to an ImGui window, so that's what is being created here.
-    glBindTexture(GL_TEXTURE_2D, win.cfg.texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, win.cfg.w, win.cfg.h, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    // An antialiased texture doesn't work with ImGui's AddImage() function, so a workaround would be necessary for this.
-    // glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, win.cfg.texture);
-    //     glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, MSAA_SAMPLES, GL_RGBA, win.cfg.w, win.cfg.h, GL_TRUE);
-    //     glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    //     glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    // glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
-
-    glBindFramebuffer(GL_FRAMEBUFFER, win.cfg.frameBuffer);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, win.cfg.texture, 0);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    // glBindFramebuffer(GL_FRAMEBUFFER, win.cfg.frameBuffer);
-    //     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D_MULTISAMPLE, win.cfg.texture, 0);
-    // glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    // clang-format on
+    createPreviewFrameBuffer();
 
     // Set customized GLFW callbacks.
     // NOTE: set GLFW callbacks before ImGui creation (otherwise you can will have missing events if you call ImGui_ImplGlfw_InitForOpenGL(window, true) first).
@@ -813,9 +1189,7 @@ void createCfgWin() {
     ImGui_ImplGlfw_InitForOpenGL(win.cfg.glfw, false); // second param == false --> do not auto install callbacks because they are already defined above
     ImGui_ImplOpenGL3_Init(GLSL_VER);
 
-    pre.min = std::make_unique<Star>(Enum::Star::GenType::MIN);
-    pre.avg = std::make_unique<Star>(Enum::Star::GenType::AVG);
-    pre.max = std::make_unique<Star>(Enum::Star::GenType::MAX);
+    pre.generate();
 
     if (cfg.forceVisiblePreview) pre.forceVisible();
 
@@ -825,22 +1199,20 @@ void createCfgWin() {
 void destroyCfgWin() {
     if (!win.cfg.exists) return;
 
-    glfwMakeContextCurrent(NULL);
-    glfwMakeContextCurrent(win.cfg.glfw);
+    makeContextCurrent(win.cfg.glfw);
 
     ImGui::SetCurrentContext(win.cfg.imgui);
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
 
-    glDeleteTextures(1, &win.cfg.texture);
-    glDeleteFramebuffers(1, &win.cfg.frameBuffer);
+    destroyPreviewFrameBuffer();
 
-    glfwDestroyWindow(win.cfg.glfw);
+    // the preview stars release their program, which has to happen while the config window's context still exists
+    pre.renderer.clear();
+    pre.stars.clear();
 
-    pre.min.reset();
-    pre.avg.reset();
-    pre.max.reset();
+    glfwDestroyWindow(win.cfg.glfw);
 
     win.cfg.glfw   = NULL;
     win.cfg.imgui  = NULL;
@@ -854,14 +1226,49 @@ void createDestroyCfgWin() {
     else createCfgWin();
 }
 
+// frame buffer that the preview stars are drawn into, in the current context (the config window's, or the offscreen context)
+void createPreviewFrameBuffer() {
+    glGenFramebuffers(1, &win.cfg.frameBuffer);
+    glGenTextures(1, &win.cfg.texture);
+
+    // clang-format off
+    // This texture is used for the preview window.
+    // ImGui requires a texture to be able to add a custom image to an ImGui window, so that's what is being created here.
+    glBindTexture(GL_TEXTURE_2D, win.cfg.texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, win.cfg.w, win.cfg.h, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // An antialiased texture doesn't work with ImGui's AddImage() function, so a workaround would be necessary for this.
+    // glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, win.cfg.texture);
+    //     glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, MSAA_SAMPLES, GL_RGBA, win.cfg.w, win.cfg.h, GL_TRUE);
+    //     glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    //     glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, win.cfg.frameBuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, win.cfg.texture, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // glBindFramebuffer(GL_FRAMEBUFFER, win.cfg.frameBuffer);
+    //     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D_MULTISAMPLE, win.cfg.texture, 0);
+    // glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // clang-format on
+}
+
+void destroyPreviewFrameBuffer() {
+    glDeleteTextures(1, &win.cfg.texture);
+    glDeleteFramebuffers(1, &win.cfg.frameBuffer);
+}
+
 void maximizeRestoreWin(GLFWwindow* window) {
     if (glfwGetWindowAttrib(window, GLFW_MAXIMIZED)) glfwRestoreWindow(window);
     else glfwMaximizeWindow(window);
 }
 
 void clearWin(GLFWwindow* window) {
-    glfwMakeContextCurrent(NULL);
-    glfwMakeContextCurrent(window);
+    makeContextCurrent(window);
 
     glClearColor(cfg.backgroundColor.r, cfg.backgroundColor.g, cfg.backgroundColor.b, cfg.backgroundColor.a);
     glClear(GL_COLOR_BUFFER_BIT);
@@ -869,7 +1276,7 @@ void clearWin(GLFWwindow* window) {
 
 void setMainWinTitle() {
     int r = mainWinTitle.countR;
-    int v = stars.size();
+    int v = sim.stars.size();
 
     // r should never be less than countL here if v is never more than 4 digits
     for (; v > 0; r--) {
@@ -0,0 +1,43 @@
+#include "narrowphase.h"
+#include "simd.h"
+
+std::uint32_t overlapScalar(const CollisionCircle& a, const CollisionCircle* circles, const unsigned* b, unsigned first, unsigned count) {
+    std::uint32_t mask = 0;
+
+    for (unsigned k = 0; k < count; k++) {
+        if (circlesOverlap(a, circles[b ? b[k] : first + k])) mask |= std::uint32_t(1) << k;
+    }
+
+    return mask;
+}
+
+void resolveContactsScalar(const ContactArrays& s, const std::pair<unsigned, unsigned>* contacts, unsigned count) {
+    for (unsigned k = 0; k < count; k++) {
+        auto [a, b] = contacts[k];
+
+        resolveContact(s.x[a], s.y[a], s.x[b], s.y[b],
+                       s.xVel[a], s.yVel[a], s.xVel[b], s.yVel[b],
+                       s.radius[a] + s.radius[b], s.mass[a], s.mass[b]);
+    }
+}
+
+NarrowphaseKernels selectNarrowphaseKernels() {
+    SIMDLevel level = detectSIMDLevel();
+
+    switch (level) {
+        using enum SIMDLevel;
+
+        case SSE2: {
+            return {getName(level), overlapSSE2, resolveContactsSSE2};
+        }
+        case AVX2: {
+            return {getName(level), overlapAVX2, resolveContactsAVX2};
+        }
+        case AVX512: {
+            return {getName(level), overlapAVX512, resolveContactsAVX512};
+        }
+        default: {
+            return {getName(level), overlapScalar, resolveContactsScalar};
+        }
+    }
+}
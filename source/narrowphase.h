@@ -0,0 +1,89 @@
+#ifndef NARROWPHASE_H_GUARD
+#define NARROWPHASE_H_GUARD
+
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+#include "broadphase.h"
+#include "overlap_correction.h"
+#include "elastic_collision_response.h"
+
+/*
+Narrowphase: exact collision circle tests and contact response, split into two stages.
+
+    1. overlap: tests a batch of candidate pairs (a, b[k]) that share star a and returns a bit mask of the overlapping pairs
+    2. contact response: resolves a batch of disjoint contacts (overlap correction, then elastic collision response)
+
+Both stages have a scalar reference (circlesOverlap(), resolveContact()) and SIMD kernels that process 2/4/8 pairs at once (see simd.h).
+The SIMD kernels produce bit-identical results.
+*/
+
+// stars that are passed to the contact response: indexed by star index, positions/velocities are updated in place
+struct ContactArrays {
+    double* x;
+    double* y;
+    double* xVel;
+    double* yVel;
+    const double* radius;
+    const double* mass;
+};
+
+// pairs (a, b[k]) with b[k] == first + k if b is nullptr; at most OVERLAP_BATCH pairs
+using OverlapKernel = std::uint32_t (*)(const CollisionCircle&, const CollisionCircle*, const unsigned*, unsigned, unsigned);
+// contacts must be disjoint: no star may appear in more than one of them
+using ContactKernel = void (*)(const ContactArrays&, const std::pair<unsigned, unsigned>*, unsigned);
+
+struct NarrowphaseKernels {
+    static constexpr unsigned OVERLAP_BATCH = 32; // bits in the mask
+
+    const char* name;
+    OverlapKernel overlap;
+    ContactKernel resolve;
+};
+
+// the circles are read as a strided array of doubles by the SIMD kernels
+static_assert(sizeof(CollisionCircle) == 3 * sizeof(double));
+
+inline bool circlesOverlap(const CollisionCircle& a, const CollisionCircle& b) {
+    double x     = a.x - b.x;
+    double y     = a.y - b.y;
+    double radii = a.r + b.r;
+
+    return x * x + y * y <= radii * radii; // avoid sqrt() since most candidates do not overlap
+}
+
+/*
+Collision response of two overlapping collision circles: separates them, then exchanges momentum.
+See StarSystem::collision() for why the collision circles use the average radius of the stars.
+*/
+inline void resolveContact(double& a_x, double& a_y, double& b_x, double& b_y,
+                           double& a_x_vel, double& a_y_vel, double& b_x_vel, double& b_y_vel,
+                           double radii, double a_mass, double b_mass) {
+    double x = a_x - b_x;
+    double y = a_y - b_y;
+
+    // defined in overlap_correction.h
+    overlapCorrection(a_x, a_y, b_x, b_y,
+                      radii, sqrt(x * x + y * y));
+
+    // defined in elastic_collision_response.h
+    elasticCollisionResponse(a_x, a_y, b_x, b_y,
+                             a_x_vel, a_y_vel, b_x_vel, b_y_vel,
+                             a_mass, b_mass);
+}
+
+std::uint32_t overlapScalar(const CollisionCircle&, const CollisionCircle*, const unsigned*, unsigned, unsigned);
+std::uint32_t overlapSSE2(const CollisionCircle&, const CollisionCircle*, const unsigned*, unsigned, unsigned);
+std::uint32_t overlapAVX2(const CollisionCircle&, const CollisionCircle*, const unsigned*, unsigned, unsigned);
+std::uint32_t overlapAVX512(const CollisionCircle&, const CollisionCircle*, const unsigned*, unsigned, unsigned);
+
+void resolveContactsScalar(const ContactArrays&, const std::pair<unsigned, unsigned>*, unsigned);
+void resolveContactsSSE2(const ContactArrays&, const std::pair<unsigned, unsigned>*, unsigned);
+void resolveContactsAVX2(const ContactArrays&, const std::pair<unsigned, unsigned>*, unsigned);
+void resolveContactsAVX512(const ContactArrays&, const std::pair<unsigned, unsigned>*, unsigned);
+
+// widest kernels supported by the CPU the program runs on (see simd.h)
+NarrowphaseKernels selectNarrowphaseKernels();
+
+#endif
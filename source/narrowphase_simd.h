@@ -0,0 +1,129 @@
+#ifndef NARROWPHASE_SIMD_H_GUARD
+#define NARROWPHASE_SIMD_H_GUARD
+
+#include "narrowphase.h"
+
+// SIMD version of overlapScalar() for the instruction set wrapped by V (see simd.h)
+template <typename V>
+std::uint32_t overlapSIMD(const CollisionCircle& a, const CollisionCircle* circles, const unsigned* b, unsigned first, unsigned count) {
+    using D = typename V::D;
+    using M = typename V::M;
+
+    const D ax = V::set(a.x);
+    const D ay = V::set(a.y);
+    const D ar = V::set(a.r);
+
+    std::uint32_t mask = 0;
+
+    for (unsigned k = 0; k < count; k += V::WIDTH) {
+        unsigned n = count - k < V::WIDTH ? count - k : V::WIDTH;
+
+        // a partial batch is padded with its first pair and the padding is masked off below
+        unsigned padded[V::WIDTH];
+        const unsigned* index = padded;
+
+        if (b && n == V::WIDTH) {
+            index = b + k;
+        } else {
+            for (unsigned l = 0; l < V::WIDTH; l++) {
+                unsigned m = l < n ? k + l : k;
+                padded[l]  = b ? b[m] : first + m;
+            }
+        }
+
+        D x     = V::sub(ax, V::gather(&circles->x, index, 3));
+        D y     = V::sub(ay, V::gather(&circles->y, index, 3));
+        D radii = V::add(ar, V::gather(&circles->r, index, 3));
+
+        M overlap = V::le(V::add(V::mul(x, x), V::mul(y, y)), V::mul(radii, radii));
+
+        mask |= (V::bits(overlap) & ((std::uint32_t(1) << n) - 1)) << k;
+    }
+
+    return mask;
+}
+
+// SIMD version of resolveContactsScalar() for the instruction set wrapped by V (see simd.h)
+template <typename V>
+void resolveContactsSIMD(const ContactArrays& s, const std::pair<unsigned, unsigned>* contacts, unsigned count) {
+    using D = typename V::D;
+    using M = typename V::M;
+
+    const D zero = V::set(0.0);
+    const D two  = V::set(2.0);
+
+    unsigned k = 0;
+
+    for (; k + V::WIDTH <= count; k += V::WIDTH) {
+        unsigned a[V::WIDTH];
+        unsigned b[V::WIDTH];
+
+        for (unsigned l = 0; l < V::WIDTH; l++) {
+            a[l] = contacts[k + l].first;
+            b[l] = contacts[k + l].second;
+        }
+
+        D ax    = V::gather(s.x, a, 1);
+        D ay    = V::gather(s.y, a, 1);
+        D bx    = V::gather(s.x, b, 1);
+        D by    = V::gather(s.y, b, 1);
+        D radii = V::add(V::gather(s.radius, a, 1), V::gather(s.radius, b, 1));
+
+        // overlap correction (see overlap_correction.h), coincident centers are pushed apart along the x axis
+        D x        = V::sub(ax, bx);
+        D y        = V::sub(ay, by);
+        D distance = V::sqrt(V::add(V::mul(x, x), V::mul(y, y)));
+        M coincide = V::eq(distance, zero);
+
+        D scalar = V::div(V::div(V::sub(radii, distance), two), distance);
+        D half   = V::div(radii, two);
+
+        x = V::mul(x, scalar);
+        y = V::mul(y, scalar);
+
+        ax = V::select(coincide, V::add(ax, half), V::add(ax, x));
+        ay = V::select(coincide, ay, V::add(ay, y));
+        bx = V::select(coincide, V::sub(bx, half), V::sub(bx, x));
+        by = V::select(coincide, by, V::sub(by, y));
+
+        // elastic collision response (see elastic_collision_response.h), velocities of coincident centers are left unchanged
+        D aXVel = V::gather(s.xVel, a, 1);
+        D aYVel = V::gather(s.yVel, a, 1);
+        D bXVel = V::gather(s.xVel, b, 1);
+        D bYVel = V::gather(s.yVel, b, 1);
+        D aMass = V::gather(s.mass, a, 1);
+        D bMass = V::gather(s.mass, b, 1);
+
+        x = V::sub(ax, bx);
+        y = V::sub(ay, by);
+
+        D squared = V::add(V::mul(x, x), V::mul(y, y));
+        M still   = V::eq(squared, zero);
+
+        D temp = V::mul(V::div(two, V::add(aMass, bMass)),
+                        V::div(V::add(V::mul(V::sub(aXVel, bXVel), x), V::mul(V::sub(aYVel, bYVel), y)),
+                               squared));
+
+        x = V::mul(x, temp);
+        y = V::mul(y, temp);
+
+        aXVel = V::select(still, aXVel, V::sub(aXVel, V::mul(bMass, x)));
+        aYVel = V::select(still, aYVel, V::sub(aYVel, V::mul(bMass, y)));
+        bXVel = V::select(still, bXVel, V::add(bXVel, V::mul(aMass, x)));
+        bYVel = V::select(still, bYVel, V::add(bYVel, V::mul(aMass, y)));
+
+        // the contacts are disjoint, so the lanes can be scattered back in any order
+        V::scatter(s.x, a, ax);
+        V::scatter(s.y, a, ay);
+        V::scatter(s.x, b, bx);
+        V::scatter(s.y, b, by);
+        V::scatter(s.xVel, a, aXVel);
+        V::scatter(s.yVel, a, aYVel);
+        V::scatter(s.xVel, b, bXVel);
+        V::scatter(s.yVel, b, bYVel);
+    }
+
+    resolveContactsScalar(s, contacts + k, count - k);
+}
+
+#endif
@@ -0,0 +1,151 @@
+#include <iostream>
+
+#include <glad/gl.h>
+
+#ifdef STARS_OFFSCREEN
+    #include <EGL/egl.h>
+    #include <EGL/eglext.h>
+#endif
+
+#include "offscreen_context.h"
+
+// creates the context (GL major.minor core) and its frame buffers (w x h, samples); the context stays current until destroy()
+bool OffscreenContext::create(int width, int height, int major, int minor, int samples) {
+    if (exists) return true;
+
+#ifdef STARS_OFFSCREEN
+    EGLDisplay d = EGL_NO_DISPLAY;
+
+    // the surfaceless platform does not need a window system or a GPU (Mesa falls back to llvmpipe)
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+    if (getPlatformDisplay) d = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    if (d == EGL_NO_DISPLAY) d = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    if (d == EGL_NO_DISPLAY || !eglInitialize(d, NULL, NULL)) {
+        std::cerr << "OffscreenContext::create(): no EGL display\n";
+        return false;
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cerr << "OffscreenContext::create(): eglBindAPI(EGL_OPENGL_API): failed\n";
+        eglTerminate(d);
+        return false;
+    }
+
+    // surfaceless, so any config that supports desktop GL will do
+    const EGLint configAttributes[] = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_SURFACE_TYPE, 0, EGL_NONE};
+    EGLConfig config;
+    EGLint configs = 0;
+
+    if (!eglChooseConfig(d, configAttributes, &config, 1, &configs) || configs < 1) {
+        const EGLint anyAttributes[] = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+
+        if (!eglChooseConfig(d, anyAttributes, &config, 1, &configs) || configs < 1) {
+            std::cerr << "OffscreenContext::create(): no EGL config with OpenGL support\n";
+            eglTerminate(d);
+            return false;
+        }
+    }
+
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, major,
+        EGL_CONTEXT_MINOR_VERSION, minor,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE};
+
+    EGLContext c = eglCreateContext(d, config, EGL_NO_CONTEXT, contextAttributes);
+
+    if (c == EGL_NO_CONTEXT || !eglMakeCurrent(d, EGL_NO_SURFACE, EGL_NO_SURFACE, c)) {
+        std::cerr << "OffscreenContext::create(): no surfaceless OpenGL " << major << "." << minor << " core context\n";
+        if (c != EGL_NO_CONTEXT) eglDestroyContext(d, c);
+        eglTerminate(d);
+        return false;
+    }
+
+    display = d;
+    context = c;
+
+    if (!gladLoadGL(reinterpret_cast<GLADloadfunc>(eglGetProcAddress))) {
+        std::cerr << "gladLoadGL(eglGetProcAddress): failed\n";
+        destroy();
+        return false;
+    }
+
+    w = width;
+    h = height;
+
+    glGenRenderbuffers(1, &colorBuffer);
+    glGenRenderbuffers(1, &resolveColorBuffer);
+    glGenFramebuffers(1, &frameBuffer);
+    glGenFramebuffers(1, &resolveFrameBuffer);
+
+    // clang-format off
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_RGBA8, w, h);
+    glBindRenderbuffer(GL_RENDERBUFFER, resolveColorBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, w, h);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, resolveFrameBuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, resolveColorBuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    // clang-format on
+
+    exists = true;
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "OffscreenContext::create(): incomplete frame buffer\n";
+        destroy();
+        return false;
+    }
+
+    glViewport(0, 0, w, h);
+
+    return true;
+#else
+    (void)width, (void)height, (void)major, (void)minor, (void)samples;
+
+    std::cerr << "OffscreenContext::create(): built without STARS_OFFSCREEN\n";
+    return false;
+#endif
+}
+
+void OffscreenContext::destroy() {
+#ifdef STARS_OFFSCREEN
+    if (!display) return;
+
+    if (exists) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &frameBuffer);
+        glDeleteFramebuffers(1, &resolveFrameBuffer);
+        glDeleteRenderbuffers(1, &colorBuffer);
+        glDeleteRenderbuffers(1, &resolveColorBuffer);
+    }
+
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (context) eglDestroyContext(display, context);
+    eglTerminate(display);
+#endif
+
+    display = nullptr;
+    context = nullptr;
+
+    frameBuffer        = 0;
+    colorBuffer        = 0;
+    resolveFrameBuffer = 0;
+    resolveColorBuffer = 0;
+
+    exists = false;
+}
+
+// resolves the multisampled frame buffer into the single sampled one (the offscreen equivalent of swapping buffers); frameBuffer stays bound for drawing
+void OffscreenContext::resolve() {
+    // clang-format off
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, frameBuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, resolveFrameBuffer);
+        glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer);
+    // clang-format on
+}
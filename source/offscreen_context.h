@@ -0,0 +1,31 @@
+#ifndef OFFSCREEN_CONTEXT_H_GUARD
+#define OFFSCREEN_CONTEXT_H_GUARD
+
+/*
+GL context without a window system, for running the GL renderers in headless batch jobs.
+
+The context is a surfaceless EGL context (EGL_MESA_platform_surfaceless, or the default display with EGL_KHR_surfaceless_context), which works with llvmpipe on machines without a GPU.
+It has no default framebuffer, so everything is drawn into a multisampled framebuffer of the requested size (like the MSAA of the main window), which resolve() blits into a single sampled one that can be read back.
+
+EGL is not available with every toolchain (e.g. the MinGW build), so it is only used if the build defines STARS_OFFSCREEN (see CMakeLists.txt); otherwise create() fails.
+*/
+struct OffscreenContext {
+    void* display = nullptr; // EGLDisplay
+    void* context = nullptr; // EGLContext
+
+    int w = 0;
+    int h = 0;
+
+    unsigned frameBuffer        = 0; // multisampled; bound while the context exists
+    unsigned colorBuffer        = 0;
+    unsigned resolveFrameBuffer = 0;
+    unsigned resolveColorBuffer = 0;
+
+    bool exists = false;
+
+    bool create(int, int, int, int, int);
+    void destroy();
+    void resolve();
+};
+
+#endif
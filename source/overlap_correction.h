@@ -67,9 +67,17 @@ Mathematical steps:
     b_y -= y_component_scaled;
 
 The code in the following overlapCorrection() function is a condensed version of the above mathematical steps.
+
+Coincident centers (distance == 0) have no collision vector (and the scalar would divide by zero), so the stars are pushed apart along the x axis instead: a to the right, b to the left.
 */
 inline void overlapCorrection(double& a_x, double& a_y, double& b_x, double& b_y,
                               double radii, double distance) {
+    if (distance == 0.0) {
+        a_x += radii / 2;
+        b_x -= radii / 2;
+        return;
+    }
+
     double scalar             = (radii - distance) / 2 / distance;
     double x_component_scaled = (a_x - b_x) * scalar;
     double y_component_scaled = (a_y - b_y) * scalar;
@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <bit>
+
+#include "parallel_collisions.h"
+
+NarrowphaseKernels ParallelCollisions::kernels = selectNarrowphaseKernels();
+
+// finds every overlapping pair among the candidates (nullptr == test every pair, like the brute force loop)
+void ParallelCollisions::findContacts(JobSystem& jobs, const std::vector<CollisionCircle>& circles, const CollisionCandidates* candidates) {
+    unsigned n = circles.size();
+
+    offsets.assign(n + 1, 0);
+
+    // visits the overlapping later stars of star i in ascending order, testing them in batches
+    auto forEachContact = [&](unsigned i, auto&& f) {
+        const unsigned* b = candidates ? candidates->begin(i) : nullptr;
+        unsigned first    = i + 1;
+        unsigned count    = candidates ? candidates->end(i) - b : n - first;
+
+        for (unsigned k = 0; k < count; k += NarrowphaseKernels::OVERLAP_BATCH) {
+            unsigned batch = std::min(count - k, NarrowphaseKernels::OVERLAP_BATCH);
+
+            for (std::uint32_t mask = kernels.overlap(circles[i], circles.data(), b ? b + k : nullptr, first + k, batch); mask; mask &= mask - 1) {
+                unsigned l = std::countr_zero(mask);
+                f(b ? b[k + l] : first + k + l);
+            }
+        }
+    };
+
+    // two passes so that the contacts can be written into one contiguous array without any synchronization: count, prefix sum, fill
+
+    jobs.parallelFor(0, n, STARS_PER_JOB, [&](unsigned begin, unsigned end) {
+        for (unsigned i = begin; i < end; i++) {
+            forEachContact(i, [&](unsigned) { offsets[i + 1]++; });
+        }
+    });
+
+    for (unsigned i = 1; i <= n; i++) {
+        offsets[i] += offsets[i - 1];
+    }
+
+    contacts.resize(offsets[n]);
+
+    jobs.parallelFor(0, n, STARS_PER_JOB, [&](unsigned begin, unsigned end) {
+        for (unsigned i = begin; i < end; i++) {
+            unsigned k = offsets[i];
+            forEachContact(i, [&](unsigned j) { contacts[k++] = j; });
+        }
+    });
+}
+
+// greedy matching in star order: the same pairs that the serial loop in Simulation::collide() collides
+void ParallelCollisions::match() {
+    pairs.clear();
+
+    if (offsets.empty()) return;
+
+    unsigned n = offsets.size() - 1;
+
+    matched.assign(n, false);
+
+    for (unsigned i = 0; i < n; i++) {
+        if (matched[i]) continue;
+
+        for (unsigned k = offsets[i]; k < offsets[i + 1]; k++) {
+            unsigned j = contacts[k];
+
+            if (!matched[j]) {
+                matched[i] = matched[j] = true;
+                pairs.emplace_back(i, j);
+                break;
+            }
+        }
+    }
+}
+
+// resolves the matched pairs (overlap correction and elastic collision response)
+void ParallelCollisions::resolve(JobSystem& jobs, const ContactArrays& stars) {
+    jobs.parallelFor(0, pairs.size(), STARS_PER_JOB, [&](unsigned begin, unsigned end) {
+        kernels.resolve(stars, pairs.data() + begin, end - begin);
+    });
+}
@@ -0,0 +1,44 @@
+#ifndef PARALLEL_COLLISIONS_H_GUARD
+#define PARALLEL_COLLISIONS_H_GUARD
+
+#include <utility>
+#include <vector>
+
+#include "broadphase.h"
+#include "job_system.h"
+#include "narrowphase.h"
+
+/*
+Parallel, deterministic collision stage.
+
+The serial loop in Simulation::collide() lets every star collide with at most one other star per frame: star i collides with the first later star j that it overlaps and that has not collided yet.
+In other words, it computes a greedy matching of the contact graph in star order.
+A star's position only changes through its own collision, so every overlap test in that loop that can still lead to a collision sees the positions from before the loop.
+
+This makes it possible to split the work into three stages:
+    1. contacts: every star tests its candidates for overlap (in parallel, read-only, using the positions from before the stage)
+    2. matching: the contacts are matched greedily in star order (serial, but only touches the few actual contacts)
+    3. response: the matched pairs are disjoint, so they can be resolved in parallel without two threads ever touching the same star
+
+Stages 1 and 3 use the SIMD narrowphase kernels (see narrowphase.h).
+
+The result is identical to the serial loop and does not depend on the number of threads.
+*/
+struct ParallelCollisions {
+    static constexpr unsigned STARS_PER_JOB = 256;
+
+    // contacts of star i are contacts[offsets[i]] to contacts[offsets[i + 1] - 1], sorted in ascending order
+    std::vector<unsigned> offsets;
+    std::vector<unsigned> contacts;
+
+    std::vector<char> matched;
+    std::vector<std::pair<unsigned, unsigned>> pairs;
+
+    static NarrowphaseKernels kernels;
+
+    void findContacts(JobSystem&, const std::vector<CollisionCircle>&, const CollisionCandidates*);
+    void match();
+    void resolve(JobSystem&, const ContactArrays&);
+};
+
+#endif
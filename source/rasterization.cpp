@@ -0,0 +1,61 @@
+#include "rasterization.h"
+#include "simd.h"
+
+// triangle with the vertices <x[k], y[k]>
+bool setupEdgeFunctions(const float* x, const float* y, EdgeFunctions& e) {
+    double area = (static_cast<double>(x[1]) - x[0]) * (static_cast<double>(y[2]) - y[0]) - (static_cast<double>(x[2]) - x[0]) * (static_cast<double>(y[1]) - y[0]);
+
+    if (area == 0.0 || area != area) return false;
+
+    // the edge k runs from vertex k to vertex k + 1; a negative area flips all of them so that the interior is positive
+    double sign = area > 0.0 ? 1.0 : -1.0;
+
+    for (unsigned k = 0; k < 3; k++) {
+        unsigned l = k == 2 ? 0 : k + 1;
+
+        e.a[k] = sign * (static_cast<double>(y[k]) - y[l]);
+        e.b[k] = sign * (static_cast<double>(x[l]) - x[k]);
+        e.c[k] = sign * (static_cast<double>(x[k]) * y[l] - static_cast<double>(x[l]) * y[k]);
+
+        e.owner[k] = e.a[k] > 0.0 || (e.a[k] == 0.0 && e.b[k] > 0.0);
+    }
+
+    return true;
+}
+
+std::uint32_t coverageScalar(const EdgeFunctions& e, double x, double y, unsigned count) {
+    std::uint32_t mask = (count < 32 ? std::uint32_t(1) << count : 0) - 1;
+
+    for (unsigned k = 0; k < 3; k++) {
+        double base = e.a[k] * x + e.b[k] * y + e.c[k];
+
+        for (unsigned l = 0; l < count; l++) {
+            double v = base + e.a[k] * l;
+
+            if (!(e.owner[k] ? v >= 0.0 : v > 0.0)) mask &= ~(std::uint32_t(1) << l);
+        }
+    }
+
+    return mask;
+}
+
+RasterizationKernels selectRasterizationKernels() {
+    SIMDLevel level = detectSIMDLevel();
+
+    switch (level) {
+        using enum SIMDLevel;
+
+        case SSE2: {
+            return {getName(level), coverageSSE2};
+        }
+        case AVX2: {
+            return {getName(level), coverageAVX2};
+        }
+        case AVX512: {
+            return {getName(level), coverageAVX512};
+        }
+        default: {
+            return {getName(level), coverageScalar};
+        }
+    }
+}
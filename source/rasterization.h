@@ -0,0 +1,44 @@
+#ifndef RASTERIZATION_H_GUARD
+#define RASTERIZATION_H_GUARD
+
+#include <cstdint>
+
+/*
+Coverage kernels of the software rasterizer (see software_rasterizer.h).
+
+A triangle is rasterized with three edge functions E(x, y) = a * x + b * y + c, oriented so that the interior of the triangle is positive on all of them.
+A pixel is covered if its center is inside all three; a center that lies exactly on an edge is only covered if the edge owns it (top-left rule):
+triangles that share an edge see it with opposite orientations, so exactly one of them owns it and the pixels on the edge are blended once.
+
+A kernel tests a span of up to COVERAGE_BATCH consecutive pixel centers of one row and returns a bit mask of the covered ones.
+coverageScalar() is the reference; the SIMD kernels test 2/4/8 pixels at once (see simd.h) and produce identical masks.
+*/
+struct EdgeFunctions {
+    double a[3];
+    double b[3];
+    double c[3];
+    bool owner[3]; // covers the centers on the edge
+};
+
+// count pixel centers starting at <x, y>, stepping in x by one
+using CoverageKernel = std::uint32_t (*)(const EdgeFunctions&, double, double, unsigned);
+
+struct RasterizationKernels {
+    static constexpr unsigned COVERAGE_BATCH = 32; // bits in the mask
+
+    const char* name;
+    CoverageKernel coverage;
+};
+
+// false if the triangle has no area
+bool setupEdgeFunctions(const float*, const float*, EdgeFunctions&);
+
+std::uint32_t coverageScalar(const EdgeFunctions&, double, double, unsigned);
+std::uint32_t coverageSSE2(const EdgeFunctions&, double, double, unsigned);
+std::uint32_t coverageAVX2(const EdgeFunctions&, double, double, unsigned);
+std::uint32_t coverageAVX512(const EdgeFunctions&, double, double, unsigned);
+
+// widest kernels supported by the CPU the program runs on (see simd.h)
+RasterizationKernels selectRasterizationKernels();
+
+#endif
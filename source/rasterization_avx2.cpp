@@ -0,0 +1,20 @@
+#include "rasterization.h"
+
+#if defined(__AVX2__)
+
+    #include "rasterization_simd.h"
+    #include "simd_avx2.h"
+
+std::uint32_t coverageAVX2(const EdgeFunctions& e, double x, double y, unsigned count) {
+    return coverageSIMD<AVX2>(e, x, y, count);
+}
+
+#else
+
+// only selected if the compiler could build this file for AVX2 (see CMakeLists.txt)
+
+std::uint32_t coverageAVX2(const EdgeFunctions& e, double x, double y, unsigned count) {
+    return coverageScalar(e, x, y, count);
+}
+
+#endif
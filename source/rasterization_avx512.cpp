@@ -0,0 +1,20 @@
+#include "rasterization.h"
+
+#if defined(__AVX512F__)
+
+    #include "rasterization_simd.h"
+    #include "simd_avx512.h"
+
+std::uint32_t coverageAVX512(const EdgeFunctions& e, double x, double y, unsigned count) {
+    return coverageSIMD<AVX512>(e, x, y, count);
+}
+
+#else
+
+// only selected if the compiler could build this file for AVX-512 (see CMakeLists.txt)
+
+std::uint32_t coverageAVX512(const EdgeFunctions& e, double x, double y, unsigned count) {
+    return coverageScalar(e, x, y, count);
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef RASTERIZATION_SIMD_H_GUARD
+#define RASTERIZATION_SIMD_H_GUARD
+
+#include "rasterization.h"
+
+// SIMD version of coverageScalar() for the instruction set wrapped by V (see simd.h)
+template <typename V>
+std::uint32_t coverageSIMD(const EdgeFunctions& e, double x, double y, unsigned count) {
+    using D = typename V::D;
+    using M = typename V::M;
+
+    // offsets of the lanes from the first pixel of a step
+    double lanes[V::WIDTH];
+
+    for (unsigned l = 0; l < V::WIDTH; l++) {
+        lanes[l] = l;
+    }
+
+    const D zero = V::set(0.0);
+
+    D a[3];
+    D base[3];
+
+    for (unsigned k = 0; k < 3; k++) {
+        a[k]    = V::set(e.a[k]);
+        base[k] = V::set(e.a[k] * x + e.b[k] * y + e.c[k]);
+    }
+
+    std::uint32_t mask = 0;
+
+    for (unsigned l = 0; l < count; l += V::WIDTH) {
+        D offset  = V::add(V::load(lanes), V::set(l));
+        M covered = V::eq(zero, zero);
+
+        for (unsigned k = 0; k < 3; k++) {
+            D v = V::add(base[k], V::mul(a[k], offset));
+
+            covered = V::and_(covered, e.owner[k] ? V::ge(v, zero) : V::gt(v, zero));
+        }
+
+        mask |= V::bits(covered) << l;
+    }
+
+    // the last step may test pixels past the span
+    return mask & ((count < 32 ? std::uint32_t(1) << count : 0) - 1);
+}
+
+#endif
@@ -0,0 +1,20 @@
+#include "rasterization.h"
+
+#if defined(__SSE2__)
+
+    #include "rasterization_simd.h"
+    #include "simd_sse2.h"
+
+std::uint32_t coverageSSE2(const EdgeFunctions& e, double x, double y, unsigned count) {
+    return coverageSIMD<SSE2>(e, x, y, count);
+}
+
+#else
+
+// never selected on CPUs without SSE2
+
+std::uint32_t coverageSSE2(const EdgeFunctions& e, double x, double y, unsigned count) {
+    return coverageScalar(e, x, y, count);
+}
+
+#endif
@@ -0,0 +1,157 @@
+#include <glm/gtc/type_ptr.hpp>
+
+#include "render_queue.h"
+
+void RenderQueue::submit(Layer layer, std::uint16_t depth, const Command& c) {
+    std::uint64_t key = static_cast<std::uint64_t>(layer) << 56
+                      | static_cast<std::uint64_t>(c.program & 0xFFFF) << 40
+                      | static_cast<std::uint64_t>(c.vertexArray & 0xFFFF) << 24
+                      | static_cast<std::uint64_t>(blendIndex(c.blend) & 0xFF) << 16
+                      | depth;
+
+    packets.push_back({key, static_cast<unsigned>(commands.size())});
+    commands.push_back(c);
+}
+
+void RenderQueue::submit(Layer layer, std::uint16_t depth, void (*callback)(void*), void* context) {
+    Command c;
+    c.callback = callback;
+    c.context  = context;
+
+    packets.push_back({static_cast<std::uint64_t>(layer) << 56 | depth, static_cast<unsigned>(commands.size())});
+    commands.push_back(c);
+}
+
+// executes and clears the submitted packets; must be called while the context of the queue is current
+void RenderQueue::execute() {
+    sort();
+
+    stats = {};
+    stats.packets = packets.size();
+
+    // current state; 0/false == unknown
+    unsigned program        = 0;
+    unsigned vertexArray    = 0;
+    unsigned indirectBuffer = 0;
+    bool blendKnown         = false;
+    Blend blend;
+    bool projectionKnown = false;
+    glm::mat4 projection;
+    bool paletteKnown = false;
+    glm::vec2 palette;
+
+    // issues the state change only if it changes the state
+    auto change = [this](bool redundant, auto&& apply) {
+        if (redundant) {
+            stats.skipped++;
+        } else {
+            apply();
+            stats.stateChanges++;
+        }
+    };
+
+    for (const Packet& p : packets) {
+        const Command& c = commands[p.command];
+
+        if (c.callback) {
+            c.callback(c.context);
+
+            program         = 0;
+            vertexArray     = 0;
+            indirectBuffer  = 0;
+            blendKnown      = false;
+            projectionKnown = false;
+            paletteKnown    = false;
+
+            continue;
+        }
+
+        change(program == c.program, [&] {
+            glUseProgram(c.program);
+            program = c.program;
+
+            // uniforms are program state
+            projectionKnown = false;
+            paletteKnown    = false;
+        });
+
+        change(vertexArray == c.vertexArray, [&] {
+            glBindVertexArray(c.vertexArray);
+            vertexArray = c.vertexArray;
+        });
+
+        change(blendKnown && blend == c.blend, [&] {
+            glBlendFunc(c.blend.src, c.blend.dst);
+            blend      = c.blend;
+            blendKnown = true;
+        });
+
+        change(indirectBuffer == c.indirectBuffer, [&] {
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, c.indirectBuffer);
+            indirectBuffer = c.indirectBuffer;
+        });
+
+        change(projectionKnown && projection == c.projection, [&] {
+            glUniformMatrix4fv(0, 1, GL_FALSE, glm::value_ptr(c.projection));
+            projection      = c.projection;
+            projectionKnown = true;
+        });
+
+        change(paletteKnown && palette == c.palette, [&] {
+            glUniform2f(1, c.palette.x, c.palette.y);
+            palette      = c.palette;
+            paletteKnown = true;
+        });
+
+        glMultiDrawElementsIndirect(c.mode, GL_UNSIGNED_INT, reinterpret_cast<const void*>(c.indirect), c.drawCount, 0);
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+    glUseProgram(0);
+
+    packets.clear();
+    commands.clear();
+    blends.clear();
+}
+
+// LSD radix sort on 8-bit digits; stable, and digits that are equal in every key are skipped
+void RenderQueue::sort() {
+    unsigned n = packets.size();
+
+    scratch.resize(n);
+
+    for (unsigned shift = 0; shift < 64; shift += 8) {
+        unsigned counts[256] = {};
+
+        for (const Packet& p : packets) {
+            counts[(p.key >> shift) & 0xFF]++;
+        }
+
+        if (n == 0 || counts[(packets[0].key >> shift) & 0xFF] == n) continue;
+
+        unsigned offset = 0;
+
+        for (unsigned& c : counts) {
+            unsigned count = c;
+            c              = offset;
+            offset += count;
+        }
+
+        for (const Packet& p : packets) {
+            scratch[counts[(p.key >> shift) & 0xFF]++] = p;
+        }
+
+        packets.swap(scratch);
+    }
+}
+
+// small index of the blend state for the sort key (there are only a few distinct blend states per frame)
+unsigned RenderQueue::blendIndex(const Blend& b) {
+    for (unsigned i = 0; i < blends.size(); i++) {
+        if (blends[i] == b) return i;
+    }
+
+    blends.push_back(b);
+    return blends.size() - 1;
+}
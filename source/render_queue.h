@@ -0,0 +1,95 @@
+#ifndef RENDER_QUEUE_H_GUARD
+#define RENDER_QUEUE_H_GUARD
+
+#include <cstdint>
+#include <vector>
+
+#include <glad/gl.h>
+
+#include <glm/glm.hpp>
+
+/*
+Sorted render command queue of one context.
+
+Renderers do not issue their draw calls directly: they submit packets, which are executed together once the frame has been built.
+Every packet has a 64-bit sort key; the packets are radix sorted by key and then executed in that order, skipping every state change that would set the state it already has.
+
+Key layout (most significant first):
+    layer (8) | program (16) | vertex array (16) | blend (8) | depth (16)
+
+Layers keep independent parts of the frame in order (e.g. the preview before the ImGui overlay that displays it).
+Within a layer, packets with the same state end up next to each other; the sort is stable, so packets with equal keys keep their submission order.
+Program and vertex array names are truncated to 16 bits, which only affects how well packets are grouped: state is always compared in full.
+
+Callback packets (e.g. ImGui, binding a framebuffer) run arbitrary GL code, so the tracked state is reset after each one.
+Their program bits are 0, so they run before the draws of their layer; depth orders callbacks within a layer.
+*/
+struct RenderQueue {
+    enum Layer : std::uint8_t {
+        STARS,
+        PREVIEW,
+        OVERLAY,
+    };
+
+    // https://docs.gl/gl4/glBlendFunc
+    struct Blend {
+        GLenum src;
+        GLenum dst;
+
+        bool operator==(const Blend&) const = default;
+    };
+
+    // one command in the indirect buffer of a draw packet: https://docs.gl/gl4/glMultiDrawElementsIndirect
+    struct Indirect {
+        unsigned count;
+        unsigned instanceCount;
+        unsigned firstIndex;
+        int baseVertex;
+        unsigned baseInstance;
+    };
+
+    struct Command {
+        // callback packets only
+        void (*callback)(void*) = nullptr;
+        void* context           = nullptr;
+
+        // draw packets: glMultiDrawElementsIndirect(), with the projection at uniform location 0 and the palette at uniform location 1 of the program
+        unsigned program        = 0;
+        unsigned vertexArray    = 0;
+        Blend blend             = {GL_ONE, GL_ZERO};
+        unsigned indirectBuffer = 0;
+        GLenum mode             = GL_TRIANGLES;
+        std::uintptr_t indirect = 0; // byte offset into the indirect buffer
+        unsigned drawCount      = 0;
+        glm::mat4 projection;
+        glm::vec2 palette = {0.0f, 0.0f}; // <1 == color from the hue of the star instead of its color, hue phase of this frame (turns)>
+    };
+
+    struct Packet {
+        std::uint64_t key;
+        unsigned command;
+    };
+
+    // of the last execute()
+    struct Stats {
+        unsigned packets      = 0;
+        unsigned stateChanges = 0;
+        unsigned skipped      = 0; // redundant state changes that were not issued
+    };
+
+    std::vector<Packet> packets;
+    std::vector<Packet> scratch;
+    std::vector<Command> commands;
+    std::vector<Blend> blends; // blend states of this frame, indexed by their key bits
+
+    Stats stats;
+
+    void submit(Layer, std::uint16_t, const Command&);
+    void submit(Layer, std::uint16_t, void (*)(void*), void*);
+    void execute();
+
+    void sort();
+    unsigned blendIndex(const Blend&);
+};
+
+#endif
@@ -0,0 +1,133 @@
+#include <cstddef>
+
+#include "sdf_renderer.h"
+
+// GL objects are released by destroy() while the context is still current; this only catches renderers that still exist at exit
+SDFRenderer::~SDFRenderer() {
+    destroy();
+}
+
+// returns the instance memory of this frame (nullptr if n == 0)
+SDFRenderer::Instance* SDFRenderer::begin(unsigned n) {
+    // the draws of the last frame have been executed by now
+    if (fencePending) {
+        instances.fence();
+        commands.fence();
+        fencePending = false;
+    }
+
+    count = n;
+
+    if (n == 0) return nullptr;
+
+    if (!vertexArray) create();
+
+    return static_cast<Instance*>(instances.map(n * sizeof(Instance)));
+}
+
+// submits the draw of the instances written since begin() to the queue
+void SDFRenderer::end(RenderQueue& queue, RenderQueue::Layer layer, const RenderQueue::Blend& blend, const glm::mat4& projection, const glm::vec2& palette) {
+    if (count == 0) return;
+
+    instances.finish();
+
+    RenderQueue::Indirect* c = static_cast<RenderQueue::Indirect*>(commands.map(sizeof(RenderQueue::Indirect)));
+
+    // the quad: 6 indices, 4 vertices
+    *c = {6, count, 0, 0, static_cast<unsigned>(instances.offset() / sizeof(Instance))};
+
+    commands.finish();
+
+    if (instancesVersion != instances.version) bindInstanceAttributes();
+
+    RenderQueue::Command draw;
+    draw.program        = program;
+    draw.vertexArray    = vertexArray;
+    draw.blend          = blend;
+    draw.indirectBuffer = commands.buffer;
+    draw.mode           = GL_TRIANGLES;
+    draw.indirect       = commands.offset();
+    draw.drawCount      = 1;
+    draw.projection     = projection;
+    draw.palette        = palette;
+
+    queue.submit(layer, 0, draw);
+
+    fencePending = true;
+}
+
+void SDFRenderer::create() {
+    static const float vertices[]   = {-1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f};
+    static const unsigned indices[] = {0, 1, 2, 0, 2, 3};
+
+    programKey = ProgramRegistry::acquire(ProgramRegistry::SDF);
+    program    = ProgramRegistry::get(programKey);
+
+    glGenBuffers(1, &vertexBuffer);
+    glGenBuffers(1, &indexBuffer);
+    glGenVertexArrays(1, &vertexArray);
+
+    // sdfVertexSource: location == 0: corner of the quad
+    // clang-format off
+    glBindVertexArray(vertexArray);
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // clang-format on
+}
+
+void SDFRenderer::destroy() {
+    if (!vertexArray) return;
+
+    ProgramRegistry::release(programKey);
+
+    glDeleteVertexArrays(1, &vertexArray);
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteBuffers(1, &indexBuffer);
+
+    program      = 0;
+    vertexArray  = 0;
+    vertexBuffer = 0;
+    indexBuffer  = 0;
+
+    instances.destroy();
+    commands.destroy();
+
+    instancesVersion = 0;
+    fencePending     = false;
+}
+
+// sdfVertexSource: location == 1: <x, y, angle, oRadius>, location == 2: <iRadius, tips, full, line>, location == 3: color, location == 4: hue; all advance once per instance
+void SDFRenderer::bindInstanceAttributes() {
+    instancesVersion = instances.version;
+
+    // clang-format off
+    glBindVertexArray(vertexArray);
+        glBindBuffer(GL_ARRAY_BUFFER, instances.buffer);
+
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, x));
+        glEnableVertexAttribArray(1);
+        glVertexAttribDivisor(1, 1);
+
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, iRadius));
+        glEnableVertexAttribArray(2);
+        glVertexAttribDivisor(2, 1);
+
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, color));
+        glEnableVertexAttribArray(3);
+        glVertexAttribDivisor(3, 1);
+
+        glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, hue));
+        glEnableVertexAttribArray(4);
+        glVertexAttribDivisor(4, 1);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // clang-format on
+}
@@ -0,0 +1,57 @@
+#ifndef SDF_RENDERER_H_GUARD
+#define SDF_RENDERER_H_GUARD
+
+#include <glm/glm.hpp>
+
+#include "config.h"
+#include "render_queue.h"
+#include "shader.h"
+#include "streaming_buffer.h"
+
+/*
+Signed distance field star renderer (Config::renderMode == SDF).
+
+Every star is drawn as one quad: the fragment shader computes the signed distance to the star's outline from its tips, radii, and style (see sdfFragmentSource), and turns it into coverage over one pixel.
+The vertex cost per star is constant (4 vertices) regardless of the number of tips, and the edges are smooth without MSAA.
+
+All stars are drawn with a single indirect draw command, submitted to a render queue like the meshes of InstancedRenderer.
+GL objects are created by the first begin() and released by destroy(), which must happen while the context is still current.
+*/
+struct SDFRenderer {
+    struct Instance {
+        float x;
+        float y;
+        float angle;
+        float oRadius;
+        float iRadius;
+        float tips;
+        float full; // 1 == full core
+        float line; // 1 == line draw
+        Color color;
+        float hue; // see InstancedRenderer::Instance
+    };
+
+    ProgramRegistry::Key programKey;
+    unsigned program      = 0;
+    unsigned vertexBuffer = 0;
+    unsigned indexBuffer  = 0;
+    unsigned vertexArray  = 0;
+
+    StreamingBuffer instances;
+    unsigned instancesVersion = 0; // version of the instance buffer that the vertex array reads from
+    unsigned count            = 0; // instances written since begin()
+
+    StreamingBuffer commands;
+    bool fencePending = false;
+
+    ~SDFRenderer();
+
+    Instance* begin(unsigned);
+    void end(RenderQueue&, RenderQueue::Layer, const RenderQueue::Blend&, const glm::mat4&, const glm::vec2&);
+
+    void create();
+    void destroy();
+    void bindInstanceAttributes();
+};
+
+#endif
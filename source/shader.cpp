@@ -1,63 +1,81 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+// https://www.boost.org/doc/libs/1_79_0/libs/filesystem/doc/tutorial.html
+#include <boost/filesystem.hpp>
+
 #include "shader.h"
 
-Shader::Shader(Shape& s) {
-    glGenBuffers(1, &vertexBuffer);
-    glGenBuffers(1, &indexBuffer);
-    glGenVertexArrays(1, &vertexArray);
+std::map<ProgramRegistry::Key, ProgramRegistry::Entry> ProgramRegistry::programs;
+const void* ProgramRegistry::current = nullptr;
 
-    createProgram();
+std::string ProgramRegistry::cacheDirectory;
+unsigned ProgramRegistry::cacheHits   = 0;
+unsigned ProgramRegistry::cacheMisses = 0;
 
-    // the following indented lines contain settings that are stored in the VertexArrayObject
-    // clang-format off
-    glBindVertexArray(vertexArray);
-        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-        glBufferData(GL_ARRAY_BUFFER, s.verticesSize * sizeof(float), s.vertices.get(), GL_STATIC_DRAW);
+ProgramRegistry::Key ProgramRegistry::acquire(Variant variant) {
+    static const char* const sources[VARIANTS][2] = {
+        {instancedVertexSource, instancedFragmentSource}, // INSTANCED
+        {sdfVertexSource, sdfFragmentSource},             // SDF
+    };
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, s.indicesSize * sizeof(unsigned), s.indices.get(), GL_STATIC_DRAW);
+    Key key  = {current, variant};
+    Entry& e = programs[key];
 
-        glVertexAttribPointer(s.args_vap.index, s.args_vap.size, s.args_vap.type, s.args_vap.normalized, s.args_vap.stride, s.args_vap.pointer);
-        glEnableVertexAttribArray(s.args_vap.index);
-    glBindVertexArray(0);
-    // clang-format on
+    if (e.references++ == 0) e.program = createProgram(sources[variant][0], sources[variant][1]);
 
-    // unbinding is a redundant: before any star is drawn, its properties are bound
-    // glDisableVertexAttribArray(s.index);
-    // glBindBuffer(GL_ARRAY_BUFFER, 0);
-    // glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    return key;
 }
 
-Shader::~Shader() {
-    glDeleteProgram(program);
+void ProgramRegistry::release(const Key& key) {
+    auto it = programs.find(key);
 
-    glDeleteVertexArrays(1, &vertexArray);
+    if (it == programs.end()) return;
 
-    // necessary?
-    // glInvalidateBufferData(vertexBuffer);
-    // glInvalidateBufferData(indexBuffer);
-
-    glDeleteBuffers(1, &vertexBuffer);
-    glDeleteBuffers(1, &indexBuffer);
+    if (--it->second.references == 0) {
+        glDeleteProgram(it->second.program);
+        programs.erase(it);
+    }
 }
 
-void Shader::activate() const {
-    glUseProgram(program);
-    glBindVertexArray(vertexArray);
+unsigned ProgramRegistry::get(const Key& key) {
+    auto it = programs.find(key);
+
+    return it != programs.end() ? it->second.program : 0;
 }
 
-void Shader::deactivate() {
-    glBindVertexArray(0);
-    glUseProgram(0);
+// loads the program from the cache, or compiles it from source and adds it to the cache
+unsigned ProgramRegistry::createProgram(const char* vertex, const char* fragment) {
+    std::string path = cachePath(vertex, fragment);
+
+    if (path.empty()) return compileProgram(vertex, fragment);
+
+    unsigned program = loadProgram(path);
+
+    if (program) {
+        cacheHits++;
+        return program;
+    }
+
+    cacheMisses++;
+
+    program = compileProgram(vertex, fragment);
+    saveProgram(program, path);
+
+    return program;
 }
 
-void Shader::createProgram() {
-    unsigned vertexShader, fragmentShader;
+unsigned ProgramRegistry::compileProgram(const char* vertex, const char* fragment) {
+    unsigned vertexShader, fragmentShader, program;
 
     {
         vertexShader = glCreateShader(GL_VERTEX_SHADER);
 
         int compiled;
-        const char* sourcePtr = vertexSource;
+        const char* sourcePtr = vertex;
 
         glShaderSource(vertexShader, 1, &sourcePtr, NULL);
         glCompileShader(vertexShader);
@@ -72,7 +90,7 @@ void Shader::createProgram() {
             char log[logLength];
             glGetShaderInfoLog(vertexShader, logLength, NULL, log);
 
-            std::cerr << "ERROR: Shader::createProgram(): VERTEX: COMPILE_FAILURE:\n"
+            std::cerr << "ERROR: ProgramRegistry::compileProgram(): VERTEX: COMPILE_FAILURE:\n"
                       << log << '\n';
         };
     }
@@ -80,7 +98,7 @@ void Shader::createProgram() {
         fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
 
         int compiled;
-        const char* sourcePtr = fragmentSource;
+        const char* sourcePtr = fragment;
 
         glShaderSource(fragmentShader, 1, &sourcePtr, NULL);
         glCompileShader(fragmentShader);
@@ -95,7 +113,7 @@ void Shader::createProgram() {
             char log[logLength];
             glGetShaderInfoLog(fragmentShader, logLength, NULL, log);
 
-            std::cerr << "ERROR: Shader::createProgram(): FRAGMENT: COMPILE_FAILURE:\n"
+            std::cerr << "ERROR: ProgramRegistry::compileProgram(): FRAGMENT: COMPILE_FAILURE:\n"
                       << log << '\n';
         };
     }
@@ -106,6 +124,7 @@ void Shader::createProgram() {
 
         glAttachShader(program, vertexShader);
         glAttachShader(program, fragmentShader);
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
         glLinkProgram(program);
         glGetProgramiv(program, GL_LINK_STATUS, &linked);
 
@@ -118,7 +137,7 @@ void Shader::createProgram() {
             char log[logLength];
             glGetProgramInfoLog(program, logLength, NULL, log);
 
-            std::cerr << "ERROR: Shader::createProgram(): PROGRAM: LINK_FAILURE:\n"
+            std::cerr << "ERROR: ProgramRegistry::compileProgram(): PROGRAM: LINK_FAILURE:\n"
                       << log << '\n';
         }
     }
@@ -126,4 +145,102 @@ void Shader::createProgram() {
     // since the shaders are now compiled and linked with the program, we don't need the originals anymore
     glDeleteShader(fragmentShader);
     glDeleteShader(vertexShader);
-}
\ No newline at end of file
+
+    return program;
+}
+
+// returns 0 if there is no usable binary at path
+unsigned ProgramRegistry::loadProgram(const std::string& path) {
+    std::ifstream ifs(path, std::ifstream::in | std::ifstream::binary);
+
+    if (ifs.fail()) return 0;
+
+    // file layout: <binary format> <binary>
+    GLenum format;
+    std::vector<char> binary;
+
+    ifs.read(reinterpret_cast<char*>(&format), sizeof(format));
+    binary.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+
+    if (ifs.bad() || binary.empty()) return 0;
+
+    unsigned program = glCreateProgram();
+
+    int linked;
+
+    glProgramBinary(program, format, binary.data(), binary.size());
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+
+    // the driver may reject a binary even if its version strings did not change
+    if (!linked) {
+        glDeleteProgram(program);
+
+        ifs.close();
+        boost::system::error_code ec;
+        boost::filesystem::remove(path, ec);
+
+        return 0;
+    }
+
+    return program;
+}
+
+void ProgramRegistry::saveProgram(unsigned program, const std::string& path) {
+    int linked, length;
+
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+    if (!linked || length < 1) return;
+
+    GLenum format;
+    std::vector<char> binary(length);
+
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+
+    try {
+        if (!boost::filesystem::exists(cacheDirectory)) boost::filesystem::create_directories(cacheDirectory);
+
+        std::ofstream ofs(path, std::ofstream::out | std::ofstream::binary);
+
+        if (ofs.fail()) return;
+
+        ofs.write(reinterpret_cast<const char*>(&format), sizeof(format));
+        ofs.write(binary.data(), length);
+    } catch (std::exception& e) {
+        std::cerr << "EXCEPTION: ProgramRegistry::saveProgram(): " << e.what() << '\n';
+    }
+}
+
+// cache file of the program for the current driver; empty if caching is disabled or not supported
+std::string ProgramRegistry::cachePath(const char* vertex, const char* fragment) {
+    if (cacheDirectory.empty()) return {};
+
+    int formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+    if (formats < 1) return {};
+
+    // 64-bit FNV-1a over the driver strings and the sources (each including its terminator, so that the boundaries are part of the hash)
+    std::uint64_t hash = 14695981039346656037ull;
+
+    auto add = [&hash](const char* str) {
+        if (!str) str = "";
+
+        do {
+            hash ^= static_cast<unsigned char>(*str);
+            hash *= 1099511628211ull;
+        } while (*str++);
+    };
+
+    add(reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+    add(reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    add(reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+    add(vertex);
+    add(fragment);
+
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(hash));
+
+    return cacheDirectory + name;
+}
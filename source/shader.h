@@ -1,41 +1,200 @@
 #ifndef SHADER_H_GUARD
 #define SHADER_H_GUARD
 
+#include <compare>
 #include <iostream>
+#include <map>
+#include <string>
 
-#include "shape.h"
+#include <glad/gl.h>
 
-constexpr char vertexSource[] =
+// per-instance position, angle, scale, and color (see instanced_renderer.h); builds the same transform as StarSystem used to: projection * translate * rotate, with the scale applied to the unit-radius mesh first
+constexpr char instancedVertexSource[] =
     R"(#version 460 core
 
     layout (location = 0) in vec2 vertex;
-    layout (location = 1) uniform mat4 transform;
+    layout (location = 1) in vec4 instance; // <x, y, angle, scale>
+    layout (location = 2) in vec4 instanceColor;
+    layout (location = 3) in float instanceHue;
+    layout (location = 0) uniform mat4 projection;
+    layout (location = 1) uniform vec2 palette; // see RenderQueue::Command
+
+    out vec4 color;
+
+    // red -> yellow -> green -> cyan -> blue -> magenta -> red
+    vec3 hue(float h) {
+        return clamp(abs(mod(h * 6.0f + vec3(0.0f, 4.0f, 2.0f), 6.0f) - 3.0f) - 1.0f, 0.0f, 1.0f);
+    }
+
+    void main() {
+        float c = cos(instance.z);
+        float s = sin(instance.z);
+
+        vec2 v        = vertex * instance.w;
+        vec2 position = vec2(c * v.x - s * v.y, s * v.x + c * v.y) + instance.xy;
+
+        gl_Position  = projection * vec4(position, 0.0f, 1.0f);
+        gl_PointSize = max(2.0f * instance.w, 1.0f); // only used by the POINT LOD (GL_PROGRAM_POINT_SIZE)
+        color        = palette.x > 0.5f ? vec4(hue(fract(instanceHue + palette.y)), instanceColor.a) : instanceColor;
+    };)";
+
+constexpr char instancedFragmentSource[] =
+    R"(#version 460 core
+
+    in vec4 color;
+    out vec4 outColor;
 
     void main() {
-        gl_Position = transform * vec4(vertex.x, vertex.y, 0.0f, 1.0f);
+        outColor = color;
+    };)";
+
+// one screen-aligned quad per star (see sdf_renderer.h): the quad covers the outer radius plus one pixel for the anti-aliased edge
+constexpr char sdfVertexSource[] =
+    R"(#version 460 core
+
+    layout (location = 0) in vec2 vertex;   // corner of the quad: <+-1, +-1>
+    layout (location = 1) in vec4 instance; // <x, y, angle, oRadius>
+    layout (location = 2) in vec4 shape;    // <iRadius, tips, full core, line draw>
+    layout (location = 3) in vec4 instanceColor;
+    layout (location = 4) in float instanceHue;
+    layout (location = 0) uniform mat4 projection;
+    layout (location = 1) uniform vec2 palette; // see RenderQueue::Command
+
+    out vec2 local; // unrotated position relative to the center of the star, in pixels
+    flat out vec4 star;
+    flat out float oRadius;
+    flat out vec4 color;
+
+    // red -> yellow -> green -> cyan -> blue -> magenta -> red
+    vec3 hue(float h) {
+        return clamp(abs(mod(h * 6.0f + vec3(0.0f, 4.0f, 2.0f), 6.0f) - 3.0f) - 1.0f, 0.0f, 1.0f);
+    }
+
+    void main() {
+        float c = cos(instance.z);
+        float s = sin(instance.z);
+
+        local = vertex * (instance.w + 1.0f);
+
+        vec2 position = vec2(c * local.x - s * local.y, s * local.x + c * local.y) + instance.xy;
+
+        gl_Position = projection * vec4(position, 0.0f, 1.0f);
+        star        = shape;
+        oRadius     = instance.w;
+        color       = palette.x > 0.5f ? vec4(hue(fract(instanceHue + palette.y)), instanceColor.a) : instanceColor;
     };)";
 
-constexpr char fragmentSource[] =
+// signed distance to the same outline that StarShape builds (tips at angle 0, inner vertices in between), anti-aliased over one pixel
+constexpr char sdfFragmentSource[] =
     R"(#version 460 core
 
-    layout (location = 2) uniform vec4 uniColor;
+    in vec2 local;
+    flat in vec4 star;
+    flat in float oRadius;
+    flat in vec4 color;
     out vec4 outColor;
 
+    const float PI = 3.14159265358979f;
+
+    float segment(vec2 p, vec2 a, vec2 b) {
+        vec2 pa = p - a;
+        vec2 ba = b - a;
+
+        return length(pa - ba * clamp(dot(pa, ba) / dot(ba, ba), 0.0f, 1.0f));
+    }
+
     void main() {
-        outColor = uniColor;
+        float iRadius = star.x;
+        float slice   = PI / star.y;
+        bool full     = star.z > 0.5f;
+        bool line     = star.w > 0.5f;
+
+        // fold into half a tip: the tip is at A, the inner vertex at B, and the star is the triangle <origin, A, B>
+        float r = length(local);
+        float a = r > 0.0f ? mod(atan(local.y, local.x) + slice, 2.0f * slice) - slice : 0.0f;
+        vec2 p  = r * vec2(cos(a), abs(sin(a)));
+
+        vec2 A = vec2(oRadius, 0.0f);
+        vec2 B = iRadius * vec2(cos(slice), sin(slice));
+        vec2 e = B - A;
+        vec2 w = p - A;
+
+        // negative inside: on the origin's side of the edge
+        float outline = segment(p, A, B);
+        if (e.x * w.y - e.y * w.x > 0.0f) outline = -outline;
+
+        float d;
+
+        if (line) {
+            // GL_LINE_STRIP of the mesh: the outline, plus the lines from the center to the inner vertices if the core is full
+            d = abs(outline) - 0.5f;
+            if (full) d = min(d, segment(p, vec2(0.0f), B) - 0.5f);
+        } else {
+            // an empty core leaves out the polygon through the inner vertices
+            d = full ? outline : max(outline, B.x - p.x);
+        }
+
+        // pixel size in local units
+        float px       = max(length(vec2(dFdx(local.x), dFdy(local.x))), 1e-4f);
+        float coverage = clamp(0.5f - d / px, 0.0f, 1.0f);
+
+        if (coverage <= 0.0f) discard;
+
+        outColor = vec4(color.rgb, color.a * coverage);
     };)";
 
-struct Shader {
-    unsigned program      = 0;
-    unsigned vertexBuffer = 0;
-    unsigned indexBuffer  = 0;
-    unsigned vertexArray  = 0;
-
-    Shader(Shape&);
-    ~Shader();
-    void activate() const;
-    static void deactivate();
-    void createProgram();
+/*
+Registry of linked shader programs.
+
+Every star used to compile and link its own copy of the same program, which made spawning many stars at once stall the frame.
+Now there is one program per shader variant and OpenGL context, shared by every star drawn in that context.
+The context is part of the key because the main window and the config window (preview) do not share objects.
+
+Programs are reference counted: acquire() compiles and links a program on first use, release() deletes it once its last user is gone.
+Both must be called while the context that the program belongs to is current.
+
+Linked programs are cached on disk (glGetProgramBinary) in cacheDirectory, one file per program.
+The file name is a hash of the driver (vendor, renderer, version) and of the shader sources, so a driver update or a changed shader simply misses the cache.
+If the driver rejects a cached binary anyway, the file is removed and the program is compiled from source.
+*/
+struct ProgramRegistry {
+    enum Variant {
+        INSTANCED,
+        SDF,
+        VARIANTS,
+    };
+
+    struct Key {
+        const void* context; // see current
+        Variant variant;
+
+        auto operator<=>(const Key&) const = default;
+    };
+
+    struct Entry {
+        unsigned program    = 0;
+        unsigned references = 0;
+    };
+
+    static std::map<Key, Entry> programs;
+
+    // opaque handle of the context that is current (a GLFWwindow or the EGLContext of an OffscreenContext), set by whoever makes a context current
+    // programs are not shared between contexts, so each context has its own; the registry never asks GLFW, which is not initialized in offscreen mode
+    static const void* current;
+
+    static std::string cacheDirectory; // empty == no cache
+    static unsigned cacheHits;
+    static unsigned cacheMisses;
+
+    static Key acquire(Variant);
+    static void release(const Key&);
+    static unsigned get(const Key&);
+
+    static unsigned createProgram(const char*, const char*);
+    static unsigned compileProgram(const char*, const char*);
+    static unsigned loadProgram(const std::string&);
+    static void saveProgram(unsigned, const std::string&);
+    static std::string cachePath(const char*, const char*);
 };
 
 #endif
\ No newline at end of file
@@ -3,32 +3,29 @@
 
 #include <memory>
 
-#include <glad/gl.h>
+/*
+CPU geometry of a mesh: <x, y> vertices and the indices that assemble them into primitives.
 
+Shapes do not depend on GL: the instanced renderer uploads them to its geometry atlas (see instanced_renderer.h) and the software rasterizer reads them directly (see software_rasterizer.h).
+*/
 struct Shape {
+    // how the indices are assembled, like the GL primitive modes of the same names
+    enum class Primitive {
+        TRIANGLES,
+        LINE_STRIP,
+        POINTS,
+    };
+
     unsigned verticesSize;
     std::unique_ptr<float[]> vertices;
 
     unsigned indicesSize;
     std::unique_ptr<unsigned[]> indices;
 
-    // https://docs.gl/gl4/glVertexAttribPointer
-    struct args_glVertexAttribPointer {
-        GLuint index;
-        GLint size;
-        GLenum type;
-        GLboolean normalized;
-        GLsizei stride;
-        const void* pointer;
-    } args_vap;
-
-    // https://docs.gl/gl4/glDrawElements
-    struct args_glDrawElements {
-        GLenum mode;
-        GLsizei count;
-        GLenum type;
-        const void* indices;
-    } args_de;
+    Primitive primitive = Primitive::TRIANGLES;
+
+    // shapes are owned through Shape pointers (see StarMeshes)
+    virtual ~Shape() = default;
 };
 
 #endif
\ No newline at end of file
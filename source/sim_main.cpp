@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include "config.h"
+#include "constants.h"
+#include "job_system.h"
+#include "rng.h"
+#include "simulation.h"
+#include "software_rasterizer.h"
+#include "star.h"
+
+/*
+Headless driver of the simulation core (2d_stars_sim): runs N stars for M steps of a fixed time step in a world of a given size and prints the throughput.
+
+No window or context is created, so it runs on machines without a display or a GPU.
+Generation and physics settings come from the defaults of Config (or from a config file saved by the windowed program); the options below override them.
+
+--render FILE draws every step with the software rasterizer (see software_rasterizer.h) into a WIDTH x HEIGHT frame (the world size by default) and appends it to FILE as a PAM image.
+The frames use the background color, blend modes, and color mode of the config, and the rasterizer stages are timed separately from the physics.
+*/
+
+static const char USAGE[] = "usage: 2d_stars_sim [--stars N] [--steps M] [--dt SECONDS] [--world WIDTHxHEIGHT] [--threads T] "
+                            "[--broadphase brute|grid|sap|tree] [--serial-collisions] [--no-collisions] [--verlet] [--seed S] [--config FILE] "
+                            "[--render FILE.pam [--width W] [--height H]]\n";
+
+static const char* const broadphaseNames[] = {"BRUTE_FORCE", "SPATIAL_GRID", "SWEEP_AND_PRUNE", "AABB_TREE"};
+
+struct Options {
+    int stars               = 1000;
+    int steps               = 1000;
+    double dt               = 0.0; // 0 == 1 / cfg.targetFPS
+    int w                   = 1920;
+    int h                   = 1080;
+    bool seeded             = false;
+    unsigned long long seed = 0;
+
+    // frames of --render; 0 == world size
+    const char* render = nullptr;
+    int width          = 0;
+    int height         = 0;
+};
+
+template <typename T>
+bool parse(const char* first, const char* last, T& value) {
+    std::from_chars_result r = std::from_chars(first, last, value);
+    return r.ec == std::errc() && r.ptr == last;
+}
+
+bool parseArguments(int argc, char** argv, Options& o, Config& cfg) {
+    bool valid = true;
+
+    for (int i = 1; i < argc && valid; i++) {
+        const char* arg = argv[i];
+
+        // flags
+        if (strcmp(arg, "--serial-collisions") == 0) {
+            cfg.parallelCollisions = false;
+            continue;
+        } else if (strcmp(arg, "--no-collisions") == 0) {
+            cfg.collisions = false;
+            continue;
+        } else if (strcmp(arg, "--verlet") == 0) {
+            cfg.verletLists = true;
+            continue;
+        }
+
+        // options with a value
+        const char* value = i + 1 < argc ? argv[++i] : nullptr;
+        const char* end   = value ? value + strlen(value) : nullptr;
+
+        if (!value) {
+            valid = false;
+        } else if (strcmp(arg, "--stars") == 0) {
+            valid = parse(value, end, o.stars) && o.stars >= 0;
+        } else if (strcmp(arg, "--steps") == 0) {
+            valid = parse(value, end, o.steps) && o.steps > 0;
+        } else if (strcmp(arg, "--dt") == 0) {
+            valid = parse(value, end, o.dt) && o.dt > 0.0;
+        } else if (strcmp(arg, "--world") == 0) {
+            const char* x = std::find(value, end, 'x');
+            valid         = x != end && parse(value, x, o.w) && parse(x + 1, end, o.h) && o.w > 0 && o.h > 0;
+        } else if (strcmp(arg, "--threads") == 0) {
+            valid = parse(value, end, cfg.threads) && cfg.threads >= 0;
+        } else if (strcmp(arg, "--broadphase") == 0) {
+            static const char* const names[] = {"brute", "grid", "sap", "tree"}; // same order as Enum::Config::Broadphase
+
+            valid = false;
+
+            for (int b = 0; b < static_cast<int>(std::size(names)); b++) {
+                if (strcmp(value, names[b]) == 0) {
+                    cfg.broadphase = b;
+                    valid          = true;
+                }
+            }
+        } else if (strcmp(arg, "--seed") == 0) {
+            valid    = parse(value, end, o.seed);
+            o.seeded = true;
+        } else if (strcmp(arg, "--render") == 0) {
+            o.render = value;
+        } else if (strcmp(arg, "--width") == 0) {
+            valid = parse(value, end, o.width) && o.width > 0;
+        } else if (strcmp(arg, "--height") == 0) {
+            valid = parse(value, end, o.height) && o.height > 0;
+        } else if (strcmp(arg, "--config") == 0) {
+            // the options before --config are overwritten by the file, the options after it override the file
+            cfg.load("", value, "");
+            valid = cfg.files.last == value;
+        } else {
+            valid = false;
+        }
+    }
+
+    if (!valid) std::cerr << USAGE;
+
+    return valid;
+}
+
+int main(int argc, char** argv) {
+    using Clock = std::chrono::steady_clock;
+
+    Config cfg;
+    Options o;
+
+    if (!parseArguments(argc, argv, o, cfg)) return 1;
+
+    RNG rng;
+
+    if (o.seeded) rng.mt.seed(o.seed);
+
+    double dt = o.dt > 0.0 ? o.dt : 1.0 / cfg.targetFPS;
+
+    JobSystem jobs;
+    jobs.start(cfg.threads, cfg.pinThreads);
+
+    Simulation sim;
+    sim.stars.reserve(o.stars);
+
+    for (int i = 0; i < o.stars; i++) {
+        sim.add(Star(Enum::Star::GenType::RNG, cfg, rng, o.w, o.h));
+    }
+
+    SoftwareRasterizer rasterizer;
+    std::ofstream frames;
+
+    if (o.render) {
+        frames.open(o.render, std::ofstream::out | std::ofstream::binary);
+
+        if (frames.fail()) {
+            std::cerr << "2d_stars_sim: cannot open " << o.render << '\n';
+            jobs.stop();
+            return 1;
+        }
+
+        rasterizer.resize(o.width > 0 ? o.width : o.w, o.height > 0 ? o.height : o.h);
+
+        for (unsigned i = 0; i < sim.stars.size(); i++) {
+            rasterizer.add(sim.stars, i);
+        }
+    }
+
+    SoftwareRasterizer::Blend blend = SoftwareRasterizer::configBlend(cfg);
+    double hueShift                 = cfg.colorShiftMult * dt / Constants::HUE_STEPS;
+
+    unsigned long long collided = 0;
+
+    // only the physics: the rasterizer times its own stages, and writing the frames is timed separately
+    double seconds      = 0.0;
+    double writeSeconds = 0.0;
+
+    for (int i = 0; i < o.steps; i++) {
+        Clock::time_point start = Clock::now();
+
+        sim.step(jobs, cfg, dt, o.w, o.h);
+        collided += sim.collided;
+
+        seconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+        if (!o.render) continue;
+
+        rasterizer.clear(cfg.backgroundColor);
+        rasterizer.draw(sim.stars, jobs, blend, cfg.colorMode, hueShift);
+
+        start = Clock::now();
+
+        if (!rasterizer.write(frames)) {
+            std::cerr << "2d_stars_sim: cannot write " << o.render << '\n';
+            jobs.stop();
+            return 1;
+        }
+
+        writeSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    unsigned threads = jobs.size();
+
+    jobs.stop();
+
+    const char* broadphase = cfg.broadphase >= 0 && cfg.broadphase < static_cast<int>(std::size(broadphaseNames)) ? broadphaseNames[cfg.broadphase] : "?";
+    const char* collisions = !cfg.collisions ? "off" : cfg.parallelCollisions ? "parallel" : "serial";
+
+    printf("2d_stars_sim: %d stars, %d steps of %g s, %dx%d world, %u threads\n", o.stars, o.steps, dt, o.w, o.h, threads);
+    printf("collisions: %s, %s%s; kernels: integration %s, narrowphase %s\n",
+           collisions, broadphase, cfg.verletLists ? " + verlet lists" : "", StarSystem::integration.name, ParallelCollisions::kernels.name);
+    printf("%.3f s: %.4f ms per step, %.1f steps/s, %.3f M star-steps/s, %.2f collisions per step\n",
+           seconds, seconds * 1000.0 / o.steps, o.steps / seconds, static_cast<double>(o.stars) * o.steps / seconds / 1e6, static_cast<double>(collided) / o.steps);
+
+    if (o.render) {
+        const SoftwareRasterizer::Timings& t = rasterizer.timings;
+        double frame                         = (t.setup + t.bin + t.rasterize) * 1000.0 / t.frames;
+
+        printf("render: %u %dx%d frames to %s, coverage kernels %s, %zu triangles in the last frame\n",
+               t.frames, rasterizer.width, rasterizer.height, o.render, SoftwareRasterizer::kernels.name, rasterizer.triangles.size());
+        printf("rasterizer: %.4f ms per frame (setup %.4f ms, binning %.4f ms, rasterize %.4f ms), %.1f frames/s; writing %.4f ms per frame\n",
+               frame, t.setup * 1000.0 / t.frames, t.bin * 1000.0 / t.frames, t.rasterize * 1000.0 / t.frames, 1000.0 / frame, writeSeconds * 1000.0 / t.frames);
+    }
+}
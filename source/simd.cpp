@@ -0,0 +1,33 @@
+#include "simd.h"
+
+SIMDLevel detectSIMDLevel() {
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    // may run during static initialization, before the compiler's own CPU detection
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f")) return SIMDLevel::AVX512;
+    if (__builtin_cpu_supports("avx2")) return SIMDLevel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return SIMDLevel::SSE2;
+#endif
+
+    return SIMDLevel::SCALAR;
+}
+
+const char* getName(SIMDLevel level) {
+    switch (level) {
+        using enum SIMDLevel;
+
+        case SSE2: {
+            return "SSE2";
+        }
+        case AVX2: {
+            return "AVX2";
+        }
+        case AVX512: {
+            return "AVX-512";
+        }
+        default: {
+            return "Scalar";
+        }
+    }
+}
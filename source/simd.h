@@ -0,0 +1,31 @@
+#ifndef SIMD_H_GUARD
+#define SIMD_H_GUARD
+
+/*
+Runtime selection of the SIMD kernels (integration.h, narrowphase.h, rasterization.h).
+
+Every kernel family has a scalar reference implementation and a template that contains the SIMD version of the kernel once.
+simd_sse2.h, simd_avx2.h, and simd_avx512.h each wrap the intrinsics of one instruction set; simd_<set>.cpp instantiates the physics kernel templates with that wrapper, rasterization_<set>.cpp the coverage kernel.
+These files are compiled for their instruction set only (see CMakeLists.txt), so they must not be called unless the CPU supports it.
+For the same reason they must not use inline functions that other files use as well: the linker could pick their copy of the function for the whole program.
+
+A wrapper V provides:
+    D: vector of V::WIDTH doubles, M: lane mask
+    load, store, set, gather(base, indices, stride) == base[indices[k] * stride], scatter(base, indices, a): base[indices[k]] = a[k]
+    add, sub, mul, div, sqrt, min, max, neg
+    lt, le, gt, ge, eq: comparisons returning a mask
+    and_, or_, andNot(a, b) == !a & b, any, bits (lane k -> bit k): mask operations
+    select(m, a, b) == m ? a : b per lane
+*/
+enum class SIMDLevel {
+    SCALAR,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+// widest instruction set supported by the CPU the program runs on
+SIMDLevel detectSIMDLevel();
+const char* getName(SIMDLevel);
+
+#endif
@@ -0,0 +1,38 @@
+#include "integration.h"
+#include "narrowphase.h"
+
+#if defined(__AVX2__)
+
+    #include "integration_simd.h"
+    #include "narrowphase_simd.h"
+    #include "simd_avx2.h"
+
+void integrateAVX2(const IntegrationParams& p, const IntegrationArrays& a, unsigned begin, unsigned end) {
+    integrateSIMD<AVX2>(p, a, begin, end);
+}
+
+std::uint32_t overlapAVX2(const CollisionCircle& a, const CollisionCircle* circles, const unsigned* b, unsigned first, unsigned count) {
+    return overlapSIMD<AVX2>(a, circles, b, first, count);
+}
+
+void resolveContactsAVX2(const ContactArrays& s, const std::pair<unsigned, unsigned>* contacts, unsigned count) {
+    resolveContactsSIMD<AVX2>(s, contacts, count);
+}
+
+#else
+
+// only selected if the compiler could build this file for AVX2 (see CMakeLists.txt)
+
+void integrateAVX2(const IntegrationParams& p, const IntegrationArrays& a, unsigned begin, unsigned end) {
+    integrateScalar(p, a, begin, end);
+}
+
+std::uint32_t overlapAVX2(const CollisionCircle& a, const CollisionCircle* circles, const unsigned* b, unsigned first, unsigned count) {
+    return overlapScalar(a, circles, b, first, count);
+}
+
+void resolveContactsAVX2(const ContactArrays& s, const std::pair<unsigned, unsigned>* contacts, unsigned count) {
+    resolveContactsScalar(s, contacts, count);
+}
+
+#endif
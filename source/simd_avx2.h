@@ -0,0 +1,58 @@
+#ifndef SIMD_AVX2_H_GUARD
+#define SIMD_AVX2_H_GUARD
+
+#include <cstdint>
+
+#include <immintrin.h>
+
+// wrapper of the AVX2 intrinsics for the SIMD kernel templates (see simd.h); only included by the files that are built for AVX2
+namespace {
+struct AVX2 {
+    using D = __m256d;
+    using M = __m256d;
+
+    static constexpr unsigned WIDTH = 4;
+
+    static D load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, D a) { _mm256_storeu_pd(p, a); }
+    static D set(double a) { return _mm256_set1_pd(a); }
+    // built from scalar loads: vgatherdpd is slower than that on CPUs with the Gather Data Sampling mitigation
+    static D gather(const double* base, const unsigned* index, unsigned stride) {
+        return _mm256_set_pd(base[index[3] * stride], base[index[2] * stride], base[index[1] * stride], base[index[0] * stride]);
+    }
+    // AVX2 has no scatter
+    static void scatter(double* base, const unsigned* index, D a) {
+        alignas(32) double lanes[WIDTH];
+        _mm256_store_pd(lanes, a);
+
+        for (unsigned l = 0; l < WIDTH; l++) {
+            base[index[l]] = lanes[l];
+        }
+    }
+
+    static D add(D a, D b) { return _mm256_add_pd(a, b); }
+    static D sub(D a, D b) { return _mm256_sub_pd(a, b); }
+    static D mul(D a, D b) { return _mm256_mul_pd(a, b); }
+    static D div(D a, D b) { return _mm256_div_pd(a, b); }
+    static D sqrt(D a) { return _mm256_sqrt_pd(a); }
+    static D min(D a, D b) { return _mm256_min_pd(a, b); }
+    static D max(D a, D b) { return _mm256_max_pd(a, b); }
+    static D neg(D a) { return _mm256_xor_pd(a, _mm256_set1_pd(-0.0)); }
+
+    static M lt(D a, D b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static M le(D a, D b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+    static M gt(D a, D b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static M ge(D a, D b) { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+    static M eq(D a, D b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+
+    static M and_(M a, M b) { return _mm256_and_pd(a, b); }
+    static M or_(M a, M b) { return _mm256_or_pd(a, b); }
+    static M andNot(M a, M b) { return _mm256_andnot_pd(a, b); }
+    static bool any(M m) { return _mm256_movemask_pd(m) != 0; }
+    static std::uint32_t bits(M m) { return _mm256_movemask_pd(m); }
+
+    static D select(M m, D a, D b) { return _mm256_blendv_pd(b, a, m); }
+};
+} // namespace
+
+#endif
@@ -0,0 +1,38 @@
+#include "integration.h"
+#include "narrowphase.h"
+
+#if defined(__AVX512F__)
+
+    #include "integration_simd.h"
+    #include "narrowphase_simd.h"
+    #include "simd_avx512.h"
+
+void integrateAVX512(const IntegrationParams& p, const IntegrationArrays& a, unsigned begin, unsigned end) {
+    integrateSIMD<AVX512>(p, a, begin, end);
+}
+
+std::uint32_t overlapAVX512(const CollisionCircle& a, const CollisionCircle* circles, const unsigned* b, unsigned first, unsigned count) {
+    return overlapSIMD<AVX512>(a, circles, b, first, count);
+}
+
+void resolveContactsAVX512(const ContactArrays& s, const std::pair<unsigned, unsigned>* contacts, unsigned count) {
+    resolveContactsSIMD<AVX512>(s, contacts, count);
+}
+
+#else
+
+// only selected if the compiler could build this file for AVX-512 (see CMakeLists.txt)
+
+void integrateAVX512(const IntegrationParams& p, const IntegrationArrays& a, unsigned begin, unsigned end) {
+    integrateScalar(p, a, begin, end);
+}
+
+std::uint32_t overlapAVX512(const CollisionCircle& a, const CollisionCircle* circles, const unsigned* b, unsigned first, unsigned count) {
+    return overlapScalar(a, circles, b, first, count);
+}
+
+void resolveContactsAVX512(const ContactArrays& s, const std::pair<unsigned, unsigned>* contacts, unsigned count) {
+    resolveContactsScalar(s, contacts, count);
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef SIMD_AVX512_H_GUARD
+#define SIMD_AVX512_H_GUARD
+
+#include <cstdint>
+
+#include <immintrin.h>
+
+// wrapper of the AVX512 intrinsics for the SIMD kernel templates (see simd.h); only included by the files that are built for AVX512
+namespace {
+struct AVX512 {
+    using D = __m512d;
+    using M = __mmask8;
+
+    static constexpr unsigned WIDTH = 8;
+
+    static D load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, D a) { _mm512_storeu_pd(p, a); }
+    static D set(double a) { return _mm512_set1_pd(a); }
+    // built from scalar loads: vgatherdpd is slower than that on CPUs with the Gather Data Sampling mitigation
+    static D gather(const double* base, const unsigned* index, unsigned stride) {
+        return _mm512_set_pd(base[index[7] * stride], base[index[6] * stride], base[index[5] * stride], base[index[4] * stride],
+                             base[index[3] * stride], base[index[2] * stride], base[index[1] * stride], base[index[0] * stride]);
+    }
+    static void scatter(double* base, const unsigned* index, D a) {
+        _mm512_i32scatter_pd(base, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index)), a, 8);
+    }
+
+    static D add(D a, D b) { return _mm512_add_pd(a, b); }
+    static D sub(D a, D b) { return _mm512_sub_pd(a, b); }
+    static D mul(D a, D b) { return _mm512_mul_pd(a, b); }
+    static D div(D a, D b) { return _mm512_div_pd(a, b); }
+    static D sqrt(D a) { return _mm512_sqrt_pd(a); }
+    static D min(D a, D b) { return _mm512_min_pd(a, b); }
+    static D max(D a, D b) { return _mm512_max_pd(a, b); }
+    // AVX-512F has no floating-point xor (that is AVX-512DQ), so flip the sign bit as an integer
+    static D neg(D a) { return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a), _mm512_set1_epi64(0x8000000000000000LL))); }
+
+    static M lt(D a, D b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static M le(D a, D b) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+    static M gt(D a, D b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    static M ge(D a, D b) { return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ); }
+    static M eq(D a, D b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+
+    static M and_(M a, M b) { return a & b; }
+    static M or_(M a, M b) { return a | b; }
+    static M andNot(M a, M b) { return ~a & b; }
+    static bool any(M m) { return m != 0; }
+    static std::uint32_t bits(M m) { return m; }
+
+    static D select(M m, D a, D b) { return _mm512_mask_blend_pd(m, b, a); }
+};
+} // namespace
+
+#endif
@@ -0,0 +1,38 @@
+#include "integration.h"
+#include "narrowphase.h"
+
+#if defined(__SSE2__)
+
+    #include "integration_simd.h"
+    #include "narrowphase_simd.h"
+    #include "simd_sse2.h"
+
+void integrateSSE2(const IntegrationParams& p, const IntegrationArrays& a, unsigned begin, unsigned end) {
+    integrateSIMD<SSE2>(p, a, begin, end);
+}
+
+std::uint32_t overlapSSE2(const CollisionCircle& a, const CollisionCircle* circles, const unsigned* b, unsigned first, unsigned count) {
+    return overlapSIMD<SSE2>(a, circles, b, first, count);
+}
+
+void resolveContactsSSE2(const ContactArrays& s, const std::pair<unsigned, unsigned>* contacts, unsigned count) {
+    resolveContactsSIMD<SSE2>(s, contacts, count);
+}
+
+#else
+
+// never selected on CPUs without SSE2
+
+void integrateSSE2(const IntegrationParams& p, const IntegrationArrays& a, unsigned begin, unsigned end) {
+    integrateScalar(p, a, begin, end);
+}
+
+std::uint32_t overlapSSE2(const CollisionCircle& a, const CollisionCircle* circles, const unsigned* b, unsigned first, unsigned count) {
+    return overlapScalar(a, circles, b, first, count);
+}
+
+void resolveContactsSSE2(const ContactArrays& s, const std::pair<unsigned, unsigned>* contacts, unsigned count) {
+    resolveContactsScalar(s, contacts, count);
+}
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef SIMD_SSE2_H_GUARD
+#define SIMD_SSE2_H_GUARD
+
+#include <cstdint>
+
+#include <emmintrin.h>
+
+// wrapper of the SSE2 intrinsics for the SIMD kernel templates (see simd.h); only included by the files that are built for SSE2
+namespace {
+struct SSE2 {
+    using D = __m128d;
+    using M = __m128d;
+
+    static constexpr unsigned WIDTH = 2;
+
+    static D load(const double* p) { return _mm_loadu_pd(p); }
+    static void store(double* p, D a) { _mm_storeu_pd(p, a); }
+    static D set(double a) { return _mm_set1_pd(a); }
+    static D gather(const double* base, const unsigned* index, unsigned stride) { return _mm_set_pd(base[index[1] * stride], base[index[0] * stride]); }
+    static void scatter(double* base, const unsigned* index, D a) {
+        _mm_storel_pd(base + index[0], a);
+        _mm_storeh_pd(base + index[1], a);
+    }
+
+    static D add(D a, D b) { return _mm_add_pd(a, b); }
+    static D sub(D a, D b) { return _mm_sub_pd(a, b); }
+    static D mul(D a, D b) { return _mm_mul_pd(a, b); }
+    static D div(D a, D b) { return _mm_div_pd(a, b); }
+    static D sqrt(D a) { return _mm_sqrt_pd(a); }
+    static D min(D a, D b) { return _mm_min_pd(a, b); }
+    static D max(D a, D b) { return _mm_max_pd(a, b); }
+    static D neg(D a) { return _mm_xor_pd(a, _mm_set1_pd(-0.0)); }
+
+    static M lt(D a, D b) { return _mm_cmplt_pd(a, b); }
+    static M le(D a, D b) { return _mm_cmple_pd(a, b); }
+    static M gt(D a, D b) { return _mm_cmpgt_pd(a, b); }
+    static M ge(D a, D b) { return _mm_cmpge_pd(a, b); }
+    static M eq(D a, D b) { return _mm_cmpeq_pd(a, b); }
+
+    static M and_(M a, M b) { return _mm_and_pd(a, b); }
+    static M or_(M a, M b) { return _mm_or_pd(a, b); }
+    static M andNot(M a, M b) { return _mm_andnot_pd(a, b); }
+    static bool any(M m) { return _mm_movemask_pd(m) != 0; }
+    static std::uint32_t bits(M m) { return _mm_movemask_pd(m); }
+
+    static D select(M m, D a, D b) { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+};
+} // namespace
+
+#endif
@@ -0,0 +1,145 @@
+#include <algorithm>
+
+#include "simulation.h"
+
+void Simulation::add(const Star& s) {
+    stars.add(s);
+
+    unsigned i = stars.size() - 1;
+    tree.add({stars.x[i], stars.y[i], stars.aRadius[i]});
+}
+
+void Simulation::removeLast() {
+    stars.removeLast();
+    tree.removeLast();
+}
+
+void Simulation::clear() {
+    while (!stars.empty()) removeLast();
+}
+
+// advances the stars by frameTime seconds in a w x h world
+void Simulation::step(JobSystem& jobs, const Config& cfg, double frameTime, double w, double h) {
+    update(jobs, cfg, frameTime, w, h);
+
+    collided = 0;
+
+    if (cfg.collisions) {
+        if (cfg.parallelCollisions) collideParallel(jobs, cfg);
+        else collide(cfg);
+    }
+}
+
+// the update pass only touches the stars in its range, so the stars can be updated in parallel
+void Simulation::update(JobSystem& jobs, const Config& cfg, double frameTime, double w, double h) {
+    IntegrationParams p = StarSystem::integrationParams(cfg, frameTime, w, h);
+
+    jobs.parallelFor(0, stars.size(), STARS_PER_JOB, [&](unsigned begin, unsigned end) {
+        stars.update(begin, end, p);
+    });
+}
+
+void Simulation::collide(const Config& cfg) {
+    std::fill(stars.notCollided.begin(), stars.notCollided.end(), true);
+
+    if (cfg.broadphase == Enum::Config::Broadphase::BRUTE_FORCE) {
+        for (unsigned i = 0; i < stars.size(); i++) {
+            if (stars.notCollided[i]) {
+                for (unsigned j = i + 1; j < stars.size(); j++) {
+                    if (stars.notCollided[j] && stars.collision(i, j)) {
+                        stars.notCollided[j] = false;
+                        collided++;
+                        break;
+                    }
+                }
+            }
+        }
+    } else {
+        gatherCollisionCircles();
+
+        const CollisionCandidates& candidates = findCollisionCandidates(cfg);
+
+        // same as the brute force loop above, except that only the candidates of each star are visited
+        for (unsigned i = 0; i < stars.size(); i++) {
+            if (stars.notCollided[i]) {
+                for (const unsigned* j = candidates.begin(i); j != candidates.end(i); j++) {
+                    if (stars.notCollided[*j] && stars.collision(i, *j)) {
+                        stars.notCollided[*j] = false;
+                        collided++;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// produces the same collisions as collide(), regardless of the number of threads (see parallel_collisions.h)
+void Simulation::collideParallel(JobSystem& jobs, const Config& cfg) {
+    gatherCollisionCircles();
+
+    const CollisionCandidates* candidates = nullptr;
+
+    if (cfg.broadphase != Enum::Config::Broadphase::BRUTE_FORCE) candidates = &findCollisionCandidates(cfg);
+
+    collisions.findContacts(jobs, circles, candidates);
+    collisions.match();
+
+    std::fill(stars.notCollided.begin(), stars.notCollided.end(), true);
+
+    collisions.resolve(jobs, {stars.x.data(), stars.y.data(), stars.xVel.data(), stars.yVel.data(), stars.aRadius.data(), stars.mass.data()});
+
+    for (auto [i, j] : collisions.pairs) {
+        stars.notCollided[j] = false;
+    }
+
+    collided = collisions.pairs.size();
+}
+
+void Simulation::gatherCollisionCircles() {
+    circles.resize(stars.size());
+
+    for (unsigned i = 0; i < stars.size(); i++) {
+        circles[i] = {stars.x[i], stars.y[i], stars.aRadius[i]};
+    }
+}
+
+// returns the star pairs whose collision circles may overlap according to the selected broadphase (requires gatherCollisionCircles())
+const CollisionCandidates& Simulation::findCollisionCandidates(const Config& cfg) {
+    if (!cfg.verletLists) {
+        runBroadphase(cfg, circles, candidates);
+        return candidates;
+    }
+
+    verlet.frames++;
+
+    if (verlet.needsRebuild(circles, cfg.verletSkin)) {
+        runBroadphase(cfg, verlet.inflate(circles, cfg.verletSkin), verlet.lists);
+        verlet.rebuilt(circles, cfg.verletSkin);
+    }
+
+    return verlet.lists;
+}
+
+void Simulation::runBroadphase(const Config& cfg, const std::vector<CollisionCircle>& c, CollisionCandidates& out) {
+    switch (cfg.broadphase) {
+        using enum Enum::Config::Broadphase;
+
+        case SWEEP_AND_PRUNE: {
+            sweepAndPrune.update(c);
+            sweepAndPrune.findCandidates(c, out);
+            break;
+        }
+        case AABB_TREE: {
+            tree.update(c);
+            tree.findCandidates(c, out);
+            break;
+        }
+        case SPATIAL_GRID:
+        default: {
+            grid.build(c);
+            grid.findCandidates(c, out);
+            break;
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef SIMULATION_H_GUARD
+#define SIMULATION_H_GUARD
+
+#include <vector>
+
+#include "aabb_tree.h"
+#include "broadphase.h"
+#include "config.h"
+#include "job_system.h"
+#include "parallel_collisions.h"
+#include "spatial_grid.h"
+#include "star.h"
+#include "star_system.h"
+#include "sweep_and_prune.h"
+#include "verlet_list.h"
+
+/*
+The simulation core: the stars and the state of their collision stage, advanced one step at a time.
+
+A step is the update pass (integration, in parallel) followed by the collision pass, which is either the serial loop (collide()) or the parallel collision stage (see parallel_collisions.h); both produce the same collisions.
+Every step gets its config, time step, and world size as arguments, so nothing here depends on GL, GLFW, ImGui, or the globals of the program.
+The windowed program (main.cpp) and the headless driver (sim_main.cpp) run the same steps.
+*/
+struct Simulation {
+    static constexpr unsigned STARS_PER_JOB = 256;
+
+    StarSystem stars;
+
+    // broadphase state: gathered every step from the collision circles of the stars
+    std::vector<CollisionCircle> circles;
+    CollisionCandidates candidates;
+    SpatialGrid grid;
+    SweepAndPrune sweepAndPrune;
+    // unlike the other broadphases, the tree is maintained incrementally: stars are inserted/removed in add()/removeLast()
+    AABBTree tree;
+    // caches the candidates of the above broadphases across steps (if enabled)
+    VerletList verlet;
+    // contact detection/matching state of the parallel collision stage
+    ParallelCollisions collisions;
+
+    unsigned collided = 0; // pairs that collided in the last step
+
+    void add(const Star&);
+    void removeLast();
+    void clear();
+
+    void step(JobSystem&, const Config&, double, double, double);
+    void update(JobSystem&, const Config&, double, double, double);
+    void collide(const Config&);
+    void collideParallel(JobSystem&, const Config&);
+
+    void gatherCollisionCircles();
+    const CollisionCandidates& findCollisionCandidates(const Config&);
+    void runBroadphase(const Config&, const std::vector<CollisionCircle>&, CollisionCandidates&);
+};
+
+#endif
@@ -0,0 +1,483 @@
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+
+#include "software_rasterizer.h"
+
+RasterizationKernels SoftwareRasterizer::kernels = selectRasterizationKernels();
+
+// star i of stars was just added (the stars have to be added in order)
+void SoftwareRasterizer::add(const StarSystem& stars, unsigned i) {
+    hueRandom.push_back(wrapHue(stars.hue[i] - phase));
+    hueConsistent.push_back(wrapHue(-phase));
+    mesh.push_back(meshes.acquire(stars.tips[i], stars.iRadius[i], stars.oRadius[i], stars.style[i]));
+    lod.push_back(StarMeshes::LODS);
+}
+
+void SoftwareRasterizer::removeLast() {
+    hueRandom.pop_back();
+    hueConsistent.pop_back();
+    meshes.release(mesh.back());
+    mesh.pop_back();
+    lod.pop_back();
+}
+
+void SoftwareRasterizer::resize(int w, int h) {
+    width  = std::max(w, 0);
+    height = std::max(h, 0);
+    tilesX = (width + TILE - 1) / TILE;
+    tilesY = (height + TILE - 1) / TILE;
+
+    pixels.resize(static_cast<std::size_t>(width) * height);
+}
+
+void SoftwareRasterizer::clear(const Color& c) {
+    std::fill(pixels.begin(), pixels.end(), c);
+}
+
+// draws the stars on top of the framebuffer in the given color mode (cfg.colorMode), then advances the hue phase by shift turns
+void SoftwareRasterizer::draw(const StarSystem& stars, JobSystem& jobs, const Blend& blend, int colorMode, double shift) {
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point t0 = Clock::now();
+    setup(stars, jobs, colorMode);
+    Clock::time_point t1 = Clock::now();
+    bin(jobs);
+    Clock::time_point t2 = Clock::now();
+    rasterize(jobs, blend);
+    Clock::time_point t3 = Clock::now();
+
+    timings.setup += std::chrono::duration<double>(t1 - t0).count();
+    timings.bin += std::chrono::duration<double>(t2 - t1).count();
+    timings.rasterize += std::chrono::duration<double>(t3 - t2).count();
+    timings.frames++;
+
+    phase = wrapHue(phase + shift);
+}
+
+// binary PAM (RGBA, 8 bits per channel): http://netpbm.sourceforge.net/doc/pam.html; the images of consecutive frames can be written to the same stream
+bool SoftwareRasterizer::write(std::ostream& os) const {
+    try {
+        os << "P7\nWIDTH " << width << "\nHEIGHT " << height << "\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n";
+
+        std::vector<unsigned char> row(static_cast<std::size_t>(width) * 4);
+
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                const Color& c = pixels[static_cast<std::size_t>(y) * width + x];
+
+                row[x * 4 + 0] = static_cast<unsigned char>(std::lround(c.r * 255.0f));
+                row[x * 4 + 1] = static_cast<unsigned char>(std::lround(c.g * 255.0f));
+                row[x * 4 + 2] = static_cast<unsigned char>(std::lround(c.b * 255.0f));
+                row[x * 4 + 3] = static_cast<unsigned char>(std::lround(c.a * 255.0f));
+            }
+
+            os.write(reinterpret_cast<const char*>(row.data()), row.size());
+        }
+
+        return !os.fail();
+    } catch (std::exception& e) {
+        std::cerr << "EXCEPTION: SoftwareRasterizer::write(): " << e.what() << '\n';
+        return false;
+    }
+}
+
+// screen space triangles of every star, in star order
+void SoftwareRasterizer::setup(const StarSystem& stars, JobSystem& jobs, int colorMode) {
+    using enum Enum::Config::ColorMode;
+
+    unsigned n = stars.size();
+
+    // the projection maps one unit to one pixel, so oRadius is the on-screen radius (like StarRenderer::draw())
+    meshes.lodStats = {};
+    lodMesh.resize(n);
+
+    for (unsigned i = 0; i < n; i++) {
+        lodMesh[i] = meshes.selectMesh(mesh[i], stars.oRadius[i], lod[i]);
+    }
+
+    offsets.assign(n + 1, 0);
+
+    jobs.parallelFor(0, n, STARS_PER_JOB, [&](unsigned begin, unsigned end) {
+        for (unsigned i = begin; i < end; i++) {
+            offsets[i + 1] = triangleCount(*meshes.meshes[lodMesh[i]].shape);
+        }
+    });
+
+    for (unsigned i = 1; i <= n; i++) {
+        offsets[i] += offsets[i - 1];
+    }
+
+    triangles.resize(offsets[n]);
+
+    bool cycling = colorMode == RANDOM || colorMode == UNIFORM || colorMode == CONSISTENT;
+
+    jobs.parallelFor(0, n, STARS_PER_JOB, [&](unsigned begin, unsigned end) {
+        for (unsigned i = begin; i < end; i++) {
+            const Shape& s = *meshes.meshes[lodMesh[i]].shape;
+
+            Color color = stars.color[i];
+
+            if (cycling) {
+                float h = static_cast<float>(phase) + (colorMode == RANDOM ? hueRandom[i] : colorMode == CONSISTENT ? hueConsistent[i] : 0.0f);
+
+                color   = hue(h - std::floor(h));
+                color.a = stars.color[i].a;
+            }
+
+            // instancedVertexSource
+            float c     = std::cos(static_cast<float>(stars.ang[i]));
+            float sn    = std::sin(static_cast<float>(stars.ang[i]));
+            float scale = static_cast<float>(stars.oRadius[i]);
+            float px    = static_cast<float>(stars.x[i]);
+            float py    = static_cast<float>(stars.y[i]);
+
+            auto vertex = [&](unsigned index, float& x, float& y) {
+                float vx = s.vertices[index * 2] * scale;
+                float vy = s.vertices[index * 2 + 1] * scale;
+
+                x = c * vx - sn * vy + px;
+                y = sn * vx + c * vy + py;
+            };
+
+            Triangle* t = triangles.data() + offsets[i];
+
+            // corners of a line at one of its ends: <ux, uy> is added to the end on the side of the normal, <vx, vy> subtracted on the other side
+            struct Corners {
+                float ux, uy, vx, vy;
+            };
+
+            // two triangles that cover the line from <x0, y0> to <x1, y1>, with the corners a at its start and b at its end
+            auto quad = [&](float x0, float y0, float x1, float y1, const Corners& a, const Corners& b) {
+                t[0] = {{x0 + a.ux, x1 + b.ux, x1 - b.vx}, {y0 + a.uy, y1 + b.uy, y1 - b.vy}, color, {}};
+                t[1] = {{x0 + a.ux, x1 - b.vx, x0 - a.vx}, {y0 + a.uy, y1 - b.vy, y0 - a.vy}, color, {}};
+                t += 2;
+            };
+
+            switch (s.primitive) {
+                using enum Shape::Primitive;
+
+                case TRIANGLES: {
+                    for (unsigned k = 0; k + 2 < s.indicesSize; k += 3) {
+                        for (unsigned v = 0; v < 3; v++) {
+                            vertex(s.indices[k + v], t->x[v], t->y[v]);
+                        }
+
+                        t->color = color;
+                        t++;
+                    }
+                    break;
+                }
+                case LINE_STRIP: {
+                    // one pixel wide; the joints are mitered, so that consecutive quads share the edge across their joint and it is blended once
+                    unsigned segments = s.indicesSize > 0 ? s.indicesSize - 1 : 0;
+
+                    // normal of segment k (half a pixel long) and its length; false if the segment has no length (GL draws nothing for it)
+                    auto normal = [&](unsigned k, float& nx, float& ny, float& length) {
+                        float x0, y0, x1, y1;
+
+                        vertex(s.indices[k], x0, y0);
+                        vertex(s.indices[k + 1], x1, y1);
+
+                        length = std::hypot(x1 - x0, y1 - y0);
+
+                        if (!(length > 0.0f)) return false;
+
+                        nx = -(y1 - y0) / length * 0.5f;
+                        ny = (x1 - x0) / length * 0.5f;
+                        return true;
+                    };
+
+                    // corners of two lines with the normals a and b at their joint: on the bisector, half a pixel from either line, the outer one cut back to MITER_LIMIT
+                    // false if the inner corner lies beyond the end of either line (e.g. a line that turns back on itself), then both lines end square
+                    auto miter = [](float ax, float ay, float al, float bx, float by, float bl, Corners& o) {
+                        float d = 0.25f + ax * bx + ay * by; // 0.25 * (1 + cosine of the turn)
+
+                        if (!(d > 0.0f)) return false;
+
+                        float ox = (ax + bx) * 0.25f / d;
+                        float oy = (ay + by) * 0.25f / d;
+
+                        // distance of the corners from the joint along either line
+                        if (std::abs(ox * ay - oy * ax) * 2.0f > std::min(al, bl)) return false;
+
+                        float cut = std::min(1.0f, MITER_LIMIT * 0.5f / std::hypot(ox, oy));
+
+                        // the outer corner is on the side of the normals if the lines turn right
+                        if (ax * by - ay * bx < 0.0f) o = {ox * cut, oy * cut, ox, oy};
+                        else o = {ox, oy, ox * cut, oy * cut};
+
+                        return true;
+                    };
+
+                    // the triangles of segments without a length have no area, they are dropped by the binning stage
+                    auto skip = [&](unsigned count) {
+                        for (; count > 0; count--) quad(px, py, px, py, {}, {});
+                    };
+
+                    unsigned first = 0, last = segments;
+                    float fx = 0.0f, fy = 0.0f, fl = 0.0f, lx = 0.0f, ly = 0.0f, ll = 0.0f; // first and last segment with a length
+
+                    while (first < segments && !normal(first, fx, fy, fl)) first++;
+                    while (last > first && !normal(last - 1, lx, ly, ll)) last--;
+
+                    if (first == segments) {
+                        skip(segments);
+                        break;
+                    }
+
+                    last--;
+
+                    // a closed strip is mitered where it ends as well, the last segment ends exactly where the first one starts
+                    float x0, y0;
+                    Corners a = {fx, fy, fx, fy}, w = {};
+
+                    vertex(s.indices[first], x0, y0);
+
+                    bool wrap = first != last && s.indices[0] == s.indices[segments] && miter(lx, ly, ll, fx, fy, fl, w);
+
+                    if (wrap) a = w;
+
+                    float sx = x0, sy = y0, nx = fx, ny = fy, nl = fl;
+
+                    skip(first);
+
+                    for (unsigned k = first;;) {
+                        unsigned next = k + 1;
+                        float mx = 0.0f, my = 0.0f, ml = 0.0f;
+
+                        while (next <= last && !normal(next, mx, my, ml)) next++;
+
+                        float x1, y1;
+                        Corners b = {nx, ny, nx, ny}, j = {mx, my, mx, my};
+
+                        if (k == last && wrap) {
+                            x1 = sx;
+                            y1 = sy;
+                            b  = w;
+                        } else {
+                            vertex(s.indices[k + 1], x1, y1);
+
+                            if (next <= last && miter(nx, ny, nl, mx, my, ml, j)) b = j;
+                        }
+
+                        quad(x0, y0, x1, y1, a, b);
+                        skip(next - k - 1);
+
+                        if (next > last) break;
+
+                        x0 = x1;
+                        y0 = y1;
+                        a  = j;
+                        nx = mx;
+                        ny = my;
+                        nl = ml;
+                        k  = next;
+                    }
+
+                    skip(segments - last - 1);
+                    break;
+                }
+                default: {
+                    // POINTS: squares of the point size of instancedVertexSource
+                    float half = std::max(2.0f * scale, 1.0f) * 0.5f;
+
+                    for (unsigned k = 0; k < s.indicesSize; k++) {
+                        float x, y;
+
+                        vertex(s.indices[k], x, y);
+                        quad(x - half, y, x + half, y, {0.0f, half, 0.0f, half}, {0.0f, half, 0.0f, half});
+                    }
+                    break;
+                }
+            }
+        }
+    });
+}
+
+// sorts the triangles into the tiles their bounding boxes touch
+void SoftwareRasterizer::bin(JobSystem& jobs) {
+    unsigned tiles   = tilesX * tilesY;
+    unsigned batches = (triangles.size() + TRIANGLES_PER_BATCH - 1) / TRIANGLES_PER_BATCH;
+
+    // the lists keep their capacity from frame to frame
+    if (bins.size() < batches * tiles) bins.resize(batches * tiles);
+
+    for (std::vector<unsigned>& b : bins) {
+        b.clear();
+    }
+
+    if (tiles == 0) return;
+
+    jobs.parallelFor(0, batches, 1, [&](unsigned begin, unsigned end) {
+        for (unsigned b = begin; b < end; b++) {
+            unsigned last = std::min<unsigned>(triangles.size(), (b + 1) * TRIANGLES_PER_BATCH);
+
+            for (unsigned t = b * TRIANGLES_PER_BATCH; t < last; t++) {
+                Triangle& tri = triangles[t];
+
+                if (!setupEdgeFunctions(tri.x, tri.y, tri.edges)) continue;
+
+                float minX = std::min({tri.x[0], tri.x[1], tri.x[2]});
+                float maxX = std::max({tri.x[0], tri.x[1], tri.x[2]});
+                float minY = std::min({tri.y[0], tri.y[1], tri.y[2]});
+                float maxY = std::max({tri.y[0], tri.y[1], tri.y[2]});
+
+                if (maxX < 0.0f || maxY < 0.0f || minX >= width || minY >= height) continue;
+
+                // clamped before the conversion, the vertices may be anywhere
+                int tx0 = static_cast<int>(std::max(minX, 0.0f)) / TILE;
+                int ty0 = static_cast<int>(std::max(minY, 0.0f)) / TILE;
+                int tx1 = static_cast<int>(std::min(maxX, width - 1.0f)) / TILE;
+                int ty1 = static_cast<int>(std::min(maxY, height - 1.0f)) / TILE;
+
+                for (int ty = ty0; ty <= ty1; ty++) {
+                    for (int tx = tx0; tx <= tx1; tx++) {
+                        bins[b * tiles + ty * tilesX + tx].push_back(t);
+                    }
+                }
+            }
+        }
+    });
+}
+
+// every tile is rasterized by one job, so no two jobs ever write the same pixel
+void SoftwareRasterizer::rasterize(JobSystem& jobs, const Blend& blend) {
+    unsigned tiles   = tilesX * tilesY;
+    unsigned batches = (triangles.size() + TRIANGLES_PER_BATCH - 1) / TRIANGLES_PER_BATCH;
+
+    jobs.parallelFor(0, tiles, 1, [&](unsigned begin, unsigned end) {
+        for (unsigned t = begin; t < end; t++) {
+            int x0 = (t % tilesX) * TILE;
+            int y0 = (t / tilesX) * TILE;
+            int x1 = std::min(x0 + TILE, width) - 1;
+            int y1 = std::min(y0 + TILE, height) - 1;
+
+            for (unsigned b = 0; b < batches; b++) {
+                for (unsigned k : bins[b * tiles + t]) {
+                    rasterize(triangles[k], x0, y0, x1, y1, blend);
+                }
+            }
+        }
+    });
+}
+
+// blends the pixels of the triangle within the pixels [x0, x1] x [y0, y1]; a pixel is covered if its center is
+void SoftwareRasterizer::rasterize(const Triangle& t, int x0, int y0, int x1, int y1, const Blend& blend) {
+    // pixels whose centers can be inside the bounding box (the binning stage made sure that it overlaps the pixels)
+    x0 = static_cast<int>(std::max<float>(x0, std::ceil(std::min({t.x[0], t.x[1], t.x[2]}) - 0.5f)));
+    y0 = static_cast<int>(std::max<float>(y0, std::ceil(std::min({t.y[0], t.y[1], t.y[2]}) - 0.5f)));
+    x1 = static_cast<int>(std::min<float>(x1, std::floor(std::max({t.x[0], t.x[1], t.x[2]}) - 0.5f)));
+    y1 = static_cast<int>(std::min<float>(y1, std::floor(std::max({t.y[0], t.y[1], t.y[2]}) - 0.5f)));
+
+    for (int y = y0; y <= y1; y++) {
+        Color* row = pixels.data() + static_cast<std::size_t>(y) * width;
+
+        for (int x = x0; x <= x1; x += RasterizationKernels::COVERAGE_BATCH) {
+            unsigned count = std::min<unsigned>(x1 - x + 1, RasterizationKernels::COVERAGE_BATCH);
+
+            for (std::uint32_t mask = kernels.coverage(t.edges, x + 0.5, y + 0.5, count); mask; mask &= mask - 1) {
+                Color& p = row[x + std::countr_zero(mask)];
+                p        = SoftwareRasterizer::blend(blend, t.color, p);
+            }
+        }
+    }
+}
+
+// blend function of the config, like the windowed program sets it (out of range modes are ZERO)
+SoftwareRasterizer::Blend SoftwareRasterizer::configBlend(const Config& cfg) {
+    auto factor = [](int mode) {
+        return mode >= 0 && mode < static_cast<int>(std::size(CONFIG_FACTORS)) ? CONFIG_FACTORS[mode] : ZERO;
+    };
+
+    return {factor(cfg.srcBlendMode), factor(cfg.dstBlendMode)};
+}
+
+// triangles that setup() makes of one instance of the shape
+unsigned SoftwareRasterizer::triangleCount(const Shape& s) {
+    switch (s.primitive) {
+        using enum Shape::Primitive;
+
+        case TRIANGLES: {
+            return s.indicesSize / 3;
+        }
+        case LINE_STRIP: {
+            return s.indicesSize > 0 ? (s.indicesSize - 1) * 2 : 0;
+        }
+        default: {
+            return s.indicesSize * 2;
+        }
+    }
+}
+
+// to [0, 1), like StarRenderer::wrapHue()
+double SoftwareRasterizer::wrapHue(double hue) {
+    return hue - std::floor(hue);
+}
+
+// hue() of the star vertex shaders
+Color SoftwareRasterizer::hue(float h) {
+    auto channel = [h](float offset) {
+        return std::clamp(std::abs(std::fmod(h * 6.0f + offset, 6.0f) - 3.0f) - 1.0f, 0.0f, 1.0f);
+    };
+
+    return {channel(0.0f), channel(4.0f), channel(2.0f), 1.0f};
+}
+
+// https://docs.gl/gl4/glBlendFunc
+Color SoftwareRasterizer::factor(Factor f, const Color& s, const Color& d) {
+    switch (f) {
+        case ONE:
+        case ONE_MINUS_CONSTANT_COLOR:
+        case ONE_MINUS_CONSTANT_ALPHA:
+        case ONE_MINUS_SRC1_COLOR:
+        case ONE_MINUS_SRC1_ALPHA: {
+            return {1.0f, 1.0f, 1.0f, 1.0f};
+        }
+        case SRC_COLOR: {
+            return s;
+        }
+        case ONE_MINUS_SRC_COLOR: {
+            return {1.0f - s.r, 1.0f - s.g, 1.0f - s.b, 1.0f - s.a};
+        }
+        case DST_COLOR: {
+            return d;
+        }
+        case ONE_MINUS_DST_COLOR: {
+            return {1.0f - d.r, 1.0f - d.g, 1.0f - d.b, 1.0f - d.a};
+        }
+        case SRC_ALPHA: {
+            return {s.a, s.a, s.a, s.a};
+        }
+        case ONE_MINUS_SRC_ALPHA: {
+            return {1.0f - s.a, 1.0f - s.a, 1.0f - s.a, 1.0f - s.a};
+        }
+        case DST_ALPHA: {
+            return {d.a, d.a, d.a, d.a};
+        }
+        case ONE_MINUS_DST_ALPHA: {
+            return {1.0f - d.a, 1.0f - d.a, 1.0f - d.a, 1.0f - d.a};
+        }
+        case SRC_ALPHA_SATURATE: {
+            float i = std::min(s.a, 1.0f - d.a);
+            return {i, i, i, 1.0f};
+        }
+        default: {
+            // ZERO, and the constant and SRC1 factors (see above)
+            return {0.0f, 0.0f, 0.0f, 0.0f};
+        }
+    }
+}
+
+Color SoftwareRasterizer::blend(const Blend& b, const Color& s, const Color& d) {
+    Color f = factor(b.src, s, d);
+    Color g = factor(b.dst, s, d);
+
+    return {std::clamp(s.r * f.r + d.r * g.r, 0.0f, 1.0f),
+            std::clamp(s.g * f.g + d.g * g.g, 0.0f, 1.0f),
+            std::clamp(s.b * f.b + d.b * g.b, 0.0f, 1.0f),
+            std::clamp(s.a * f.a + d.a * g.a, 0.0f, 1.0f)};
+}
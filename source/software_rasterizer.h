@@ -0,0 +1,137 @@
+#ifndef SOFTWARE_RASTERIZER_H_GUARD
+#define SOFTWARE_RASTERIZER_H_GUARD
+
+#include <ostream>
+#include <vector>
+
+#include "config.h"
+#include "job_system.h"
+#include "rasterization.h"
+#include "star_meshes.h"
+#include "star_system.h"
+
+/*
+CPU rasterizer for star frames: draws a StarSystem into an RGBA framebuffer without a GPU, a context, or GL at all, e.g. for 2d_stars_sim --render (see sim_main.cpp).
+
+It draws the same meshes as the instanced renderer (see star_meshes.h): the CPU geometry of the mesh (and LOD) of each star, transformed like instancedVertexSource does.
+Like a StarRenderer, it keeps the per-star state (meshes, LODs, hue offsets) in arrays parallel to the arrays of its StarSystem: add(stars, i) after star i was added, removeLast() after the last star was removed.
+The cycling color modes use the hue palette of StarRenderer, with one phase for every color mode that advances once per draw().
+Stars are always drawn as meshes, even in SDF render mode.
+
+A frame is drawn in three stages on the job system, timed in timings:
+    1. setup:     every star's primitives become screen space triangles (count, prefix sum, fill, like ParallelCollisions)
+    2. binning:   batches of TRIANGLES_PER_BATCH triangles are sorted into the TILE x TILE pixel tiles they touch, one bin list per batch and tile
+    3. rasterize: every tile walks the bins of all batches in order, so each pixel sees its triangles in star order without any synchronization
+
+Coverage is tested with the SIMD edge function kernels (see rasterization.h) and every covered pixel is blended with the blend function of the frame, like glBlendFunc() with a UNORM framebuffer.
+Lines (LINE draw style) become quads one pixel wide and points become squares of the point size.
+The quads of a line strip are mitered at their joints (the outer corner cut back to MITER_LIMIT), so that each joint is covered once like with GL.
+The blend color is never set, so the constant factors use (0, 0, 0, 0); there is no second fragment output, so the SRC1 factors use 0 as well.
+
+The result does not depend on the number of threads.
+*/
+struct SoftwareRasterizer {
+    static constexpr int TILE                     = 64; // pixels
+    static constexpr unsigned TRIANGLES_PER_BATCH = 4096;
+    static constexpr unsigned STARS_PER_JOB       = 256;
+    static constexpr float MITER_LIMIT            = 4.0f; // longest miter of a line joint, in line widths
+
+    // blend factors of glBlendFunc(), with their GL values
+    enum Factor : unsigned {
+        ZERO                     = 0,
+        ONE                      = 1,
+        SRC_COLOR                = 0x0300,
+        ONE_MINUS_SRC_COLOR      = 0x0301,
+        SRC_ALPHA                = 0x0302,
+        ONE_MINUS_SRC_ALPHA      = 0x0303,
+        DST_ALPHA                = 0x0304,
+        ONE_MINUS_DST_ALPHA      = 0x0305,
+        DST_COLOR                = 0x0306,
+        ONE_MINUS_DST_COLOR      = 0x0307,
+        SRC_ALPHA_SATURATE       = 0x0308,
+        CONSTANT_COLOR           = 0x8001,
+        ONE_MINUS_CONSTANT_COLOR = 0x8002,
+        CONSTANT_ALPHA           = 0x8003,
+        ONE_MINUS_CONSTANT_ALPHA = 0x8004,
+        SRC1_ALPHA               = 0x8589,
+        SRC1_COLOR               = 0x88F9,
+        ONE_MINUS_SRC1_COLOR     = 0x88FA,
+        ONE_MINUS_SRC1_ALPHA     = 0x88FB,
+    };
+
+    // factor of each cfg.srcBlendMode and cfg.dstBlendMode, in the order of glBlendFunc_factor (main.cpp)
+    static constexpr Factor CONFIG_FACTORS[] = {
+        ZERO, ONE, SRC_COLOR, ONE_MINUS_SRC_COLOR, DST_COLOR, ONE_MINUS_DST_COLOR, SRC_ALPHA, ONE_MINUS_SRC_ALPHA, DST_ALPHA, ONE_MINUS_DST_ALPHA,
+        CONSTANT_COLOR, ONE_MINUS_CONSTANT_COLOR, CONSTANT_ALPHA, ONE_MINUS_CONSTANT_ALPHA, SRC_ALPHA_SATURATE, SRC1_COLOR, ONE_MINUS_SRC1_COLOR, SRC1_ALPHA, ONE_MINUS_SRC1_ALPHA,
+    };
+
+    struct Blend {
+        Factor src;
+        Factor dst;
+    };
+
+    struct Triangle {
+        float x[3];
+        float y[3];
+        Color color;
+        EdgeFunctions edges; // set up by the binning stage
+    };
+
+    // seconds spent in each stage, summed over frames
+    struct Timings {
+        double setup     = 0.0;
+        double bin       = 0.0;
+        double rasterize = 0.0;
+        unsigned frames  = 0;
+    };
+
+    int width  = 0;
+    int height = 0;
+    int tilesX = 0;
+    int tilesY = 0;
+
+    std::vector<Color> pixels; // rows from the top, like the projection of the stars (see StarRenderer::prepareProjection())
+
+    StarMeshes meshes;
+    std::vector<unsigned> mesh;     // see StarMeshes
+    std::vector<unsigned char> lod; // LOD that the star was drawn with in the last frame (StarMeshes::LODS == none yet)
+    std::vector<unsigned> lodMesh;  // mesh that each star is drawn with this frame
+
+    // hue offsets relative to phase (turns), see StarRenderer
+    std::vector<float> hueRandom;
+    std::vector<float> hueConsistent;
+    double phase = 0.0;
+
+    // triangles of star i are triangles[offsets[i]] to triangles[offsets[i + 1] - 1]
+    std::vector<unsigned> offsets;
+    std::vector<Triangle> triangles;
+
+    // triangles of batch b that touch tile t: bins[b * tilesX * tilesY + t], in ascending order
+    std::vector<std::vector<unsigned>> bins;
+
+    Timings timings;
+
+    static RasterizationKernels kernels;
+
+    void add(const StarSystem&, unsigned);
+    void removeLast();
+
+    void resize(int, int);
+    void clear(const Color&);
+    void draw(const StarSystem&, JobSystem&, const Blend&, int, double);
+    bool write(std::ostream&) const;
+
+    void setup(const StarSystem&, JobSystem&, int);
+    void bin(JobSystem&);
+    void rasterize(JobSystem&, const Blend&);
+    void rasterize(const Triangle&, int, int, int, int, const Blend&);
+
+    static Blend configBlend(const Config&);
+    static unsigned triangleCount(const Shape&);
+    static double wrapHue(double);
+    static Color hue(float);
+    static Color factor(Factor, const Color&, const Color&);
+    static Color blend(const Blend&, const Color&, const Color&);
+};
+
+#endif
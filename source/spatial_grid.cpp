@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <cmath>
+
+#include "spatial_grid.h"
+
+void SpatialGrid::build(const std::vector<CollisionCircle>& circles) {
+    cols = rows = 0;
+    items.clear();
+
+    if (circles.empty()) return;
+
+    // stars can be outside of the window (e.g. after it was resized), so the grid covers the bounds of all stars instead of the window
+    double xMin = circles[0].x - circles[0].r, xMax = circles[0].x + circles[0].r;
+    double yMin = circles[0].y - circles[0].r, yMax = circles[0].y + circles[0].r;
+    double rSum = 0.0;
+
+    for (const CollisionCircle& c : circles) {
+        xMin = std::min(xMin, c.x - c.r);
+        xMax = std::max(xMax, c.x + c.r);
+        yMin = std::min(yMin, c.y - c.r);
+        yMax = std::max(yMax, c.y + c.r);
+        rSum += c.r;
+    }
+
+    double w = xMax - xMin;
+    double h = yMax - yMin;
+
+    cellSize = std::max(CELL_SIZE_MIN, 2.0 * rSum / circles.size());
+
+    double cellsMax = std::max(CELLS_MIN, CELLS_PER_STAR * static_cast<int>(circles.size()));
+    double cells    = std::ceil(w / cellSize) * std::ceil(h / cellSize);
+
+    if (cells > cellsMax) cellSize *= std::sqrt(cells / cellsMax);
+
+    originX = xMin;
+    originY = yMin;
+    cols    = static_cast<int>(w / cellSize) + 1;
+    rows    = static_cast<int>(h / cellSize) + 1;
+
+    // counting sort: count the stars per cell, prefix sum the counts into cell start positions, then scatter the stars into their cells
+
+    cellStart.assign(cols * rows + 1, 0);
+
+    int x0, y0, x1, y1;
+
+    for (const CollisionCircle& c : circles) {
+        cellRange(c, x0, y0, x1, y1);
+
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                cellStart[cy * cols + cx + 1]++;
+            }
+        }
+    }
+
+    for (unsigned i = 1; i < cellStart.size(); i++) {
+        cellStart[i] += cellStart[i - 1];
+    }
+
+    cellFill.assign(cellStart.begin(), cellStart.end() - 1);
+    items.resize(cellStart.back());
+
+    for (unsigned i = 0; i < circles.size(); i++) {
+        cellRange(circles[i], x0, y0, x1, y1);
+
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                items[cellFill[cy * cols + cx]++] = i;
+            }
+        }
+    }
+}
+
+void SpatialGrid::findCandidates(const std::vector<CollisionCircle>& circles, CollisionCandidates& out) {
+    out.clear();
+
+    int x0, y0, x1, y1;
+
+    for (unsigned i = 0; i < circles.size(); i++) {
+        const CollisionCircle& a = circles[i];
+
+        scratch.clear();
+        cellRange(a, x0, y0, x1, y1);
+
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                int c = cy * cols + cx;
+
+                // items within a cell are in ascending star order, so everything up to and including i can be skipped
+                const unsigned* first = items.data() + cellStart[c];
+                const unsigned* last  = items.data() + cellStart[c + 1];
+
+                for (const unsigned* j = std::upper_bound(first, last, i); j != last; j++) {
+                    const CollisionCircle& b = circles[*j];
+                    double radii             = a.r + b.r;
+
+                    if (std::abs(a.x - b.x) <= radii && std::abs(a.y - b.y) <= radii) scratch.push_back(*j);
+                }
+            }
+        }
+
+        // two stars that share more than one cell are found once per shared cell
+        std::sort(scratch.begin(), scratch.end());
+        scratch.erase(std::unique(scratch.begin(), scratch.end()), scratch.end());
+
+        for (unsigned j : scratch) {
+            out.push(j);
+        }
+        out.next();
+    }
+}
+
+// computes the inclusive range of cells overlapped by the bounding box of a circle
+void SpatialGrid::cellRange(const CollisionCircle& c, int& x0, int& y0, int& x1, int& y1) const {
+    x0 = std::clamp(static_cast<int>((c.x - c.r - originX) / cellSize), 0, cols - 1);
+    y0 = std::clamp(static_cast<int>((c.y - c.r - originY) / cellSize), 0, rows - 1);
+    x1 = std::clamp(static_cast<int>((c.x + c.r - originX) / cellSize), 0, cols - 1);
+    y1 = std::clamp(static_cast<int>((c.y + c.r - originY) / cellSize), 0, rows - 1);
+}
@@ -0,0 +1,43 @@
+#ifndef SPATIAL_GRID_H_GUARD
+#define SPATIAL_GRID_H_GUARD
+
+#include <vector>
+
+#include "broadphase.h"
+
+/*
+Uniform grid broadphase.
+
+The grid is rebuilt from scratch every frame:
+    - the cell size is derived from the average radius distribution of the stars (twice the mean average radius, i.e. the diameter of a typical collision circle)
+    - each star is inserted into every cell that its bounding box overlaps, so stars that are much larger than a cell are still found by small stars
+    - the cell contents are stored contiguously via a counting sort keyed on cell index (no per-cell allocations)
+
+StarSystem::collision() then only has to be run on stars that share at least one cell.
+*/
+struct SpatialGrid {
+    // the cell count is limited to max(CELLS_MIN, CELLS_PER_STAR * stars) so that degenerate configurations (e.g. a few tiny stars spread over a huge area) do not allocate an excessive amount of cells
+    static constexpr double CELL_SIZE_MIN = 4.0;
+    static constexpr int CELLS_PER_STAR   = 4;
+    static constexpr int CELLS_MIN        = 1024;
+
+    double cellSize = CELL_SIZE_MIN;
+    double originX  = 0.0;
+    double originY  = 0.0;
+    int cols        = 0;
+    int rows        = 0;
+
+    // the stars in cell c are items[cellStart[c]] to items[cellStart[c + 1] - 1]
+    std::vector<unsigned> cellStart;
+    std::vector<unsigned> cellFill;
+    std::vector<unsigned> items;
+
+    // per star scratch space used while gathering candidates
+    std::vector<unsigned> scratch;
+
+    void build(const std::vector<CollisionCircle>&);
+    void findCandidates(const std::vector<CollisionCircle>&, CollisionCandidates&);
+    void cellRange(const CollisionCircle&, int&, int&, int&, int&) const;
+};
+
+#endif
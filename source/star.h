@@ -1,32 +1,26 @@
 #ifndef STAR_H_GUARD
 #define STAR_H_GUARD
 
-#include <random>
-#include <memory>
-
-#include <glad/gl.h>
-#include <GLFW/glfw3.h>
-
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
-
 #include "rng.h"
 #include "constants.h"
 #include "enums.h"
-#include "window.h"
 #include "config.h"
-#include "shader.h"
-#include "star_shape.h"
-#include "overlap_correction.h"
-#include "elastic_collision_response.h"
 
-extern struct RNG rng;
-extern struct Config cfg;
-extern struct Windows win;
-extern double frameTime;
+/*
+A single generated star.
 
+Stars are only generated with this struct (randomly or from the min/avg/max generation parameters of a config, within a world of the given size); they are then added to a StarSystem, which stores the data of all stars as contiguous arrays and implements the update and collision passes.
+*/
 struct Star {
+    using Core = Enum::Star::Shape::Core;
+    using Draw = Enum::Star::Shape::Draw;
+
+    // how the star is drawn (see StarShape)
+    struct Style {
+        Core core;
+        Draw draw;
+    };
+
     double x;
     double y;
     double xVel; // pixels per second
@@ -42,50 +36,20 @@ struct Star {
 
     double area;
     double mass;
-    double speed;
-
-    // These are floating-point types to allow smooth, FPS-independent color transitions.
-    // They are truncated to int on use.
-    double indexRandomRGBColors = 0.0;
-    static double indexUniformRGBColors;
-    double indexConsistentRGBColors = 0.0;
 
-    bool notCollided = true;
+    double hue = 0.0; // initial hue in the RANDOM color mode, in turns of the hue palette (see StarRenderer)
 
-    std::unique_ptr<Color> color;
-    std::unique_ptr<Shader> shader;
-    std::unique_ptr<Shape> shape;
+    Color color;
 
-    static std::vector<Color> RGBColors;
-    static glm::mat4 projection;
+    Style style;
 
-    Star(Enum::Star::GenType);
-
-    void update();
-    void xUpdate();
-    void yUpdate();
-    void angUpdate();
-    void gravityUpdate();
-
-    void draw();
-    void forceMove();
+    Star(Enum::Star::GenType, const Config&, RNG&, double, double);
 
     void computeMass();
     void computeArea();
-    void computeSpeed();
     void computeAverageRadius();
 
-    void reflectLeft();
-    void reflectRight();
-    void reflectTop();
-    void reflectBottom();
-
-    static void prepareProjection(int, int);
-
-    static void updateIndexUniformRGBColors();
-    static void clampIndexRGBColors(double&, int);
-
-    static bool collision(Star&, Star&);
+    static Style randomStyle(const StarStyle&, RNG&);
 };
 
 #endif
\ No newline at end of file
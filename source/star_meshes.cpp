@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include "star_meshes.h"
+
+bool StarMeshes::empty() const {
+    return lookup.empty();
+}
+
+// returns the mesh for a star with the given tips, radii, and style, creating it (and its LOD meshes) if no other star uses the same mesh class
+unsigned StarMeshes::acquire(int tips, double iRadius, double oRadius, StarShape::Style style) {
+    double ratio = oRadius > 0.0 ? std::clamp(iRadius / oRadius, 0.0, 1.0) : 1.0;
+
+    return acquireMesh({tips, static_cast<unsigned>(std::lround(ratio * RATIO_BUCKETS)), style.core, style.draw, MeshKey::STAR});
+}
+
+// freed (if given) receives the meshes whose geometry was deleted, so that a renderer can delete their GL objects as well
+void StarMeshes::release(unsigned m, std::vector<unsigned>* freed) {
+    releaseMesh(m, freed);
+
+    if (lookup.empty()) {
+        meshes.clear();
+        freeMeshes.clear();
+    }
+}
+
+unsigned StarMeshes::acquireMesh(const MeshKey& key) {
+    auto it = lookup.find(key);
+
+    if (it != lookup.end()) {
+        meshes[it->second].references++;
+        return it->second;
+    }
+
+    unsigned m;
+
+    if (freeMeshes.empty()) {
+        m = meshes.size();
+        meshes.emplace_back();
+    } else {
+        m = freeMeshes.back();
+        freeMeshes.pop_back();
+    }
+
+    // unit outer radius; a polygon is a star whose inner radius equals its outer radius
+    double radius = static_cast<double>(key.ratio) / RATIO_BUCKETS;
+
+    std::unique_ptr<Shape> shape;
+
+    {
+        using enum MeshKey::Kind;
+
+        switch (key.kind) {
+            case STAR: {
+                shape = std::make_unique<StarShape>(key.tips, radius, 1.0, StarShape::Style{key.core, key.draw});
+                break;
+            }
+            case POLYGON: {
+                shape = std::make_unique<StarShape>(key.tips, radius, radius, StarShape::Style{key.core, key.draw});
+                break;
+            }
+            case POINT: {
+                shape = pointShape();
+                break;
+            }
+        }
+    }
+
+    Mesh& mesh      = meshes[m];
+    mesh.key        = key;
+    mesh.primitives = primitives(*shape);
+    mesh.references = 1;
+    mesh.shape      = std::move(shape);
+
+    lookup.emplace(key, m);
+
+    // acquiring may grow meshes, so mesh is not used below
+    meshes[m].lods[0] = m;
+
+    for (unsigned l = 1; l < LODS; l++) {
+        MeshKey k = lodKey(key, l);
+
+        meshes[m].lods[l] = k == key ? m : acquireMesh(k);
+    }
+
+    return m;
+}
+
+void StarMeshes::releaseMesh(unsigned m, std::vector<unsigned>* freed) {
+    Mesh& mesh = meshes[m];
+
+    if (--mesh.references > 0) return;
+
+    lookup.erase(mesh.key);
+    mesh.shape.reset();
+    freeMeshes.push_back(m);
+
+    if (freed) freed->push_back(m);
+
+    unsigned lods[LODS];
+    std::copy(std::begin(mesh.lods), std::end(mesh.lods), lods);
+
+    for (unsigned l = 1; l < LODS; l++) {
+        if (lods[l] != m) releaseMesh(lods[l], freed);
+    }
+}
+
+// key of the LOD l mesh of the mesh with the given key: fewer tips, then a polygon of the average radius (always with a full core), then a point
+StarMeshes::MeshKey StarMeshes::lodKey(const MeshKey& key, unsigned l) {
+    if (key.kind != MeshKey::STAR) return key;
+
+    switch (l) {
+        case REDUCED: {
+            return {std::min(key.tips, REDUCED_TIPS), key.ratio, key.core, key.draw, MeshKey::STAR};
+        }
+        case POLYGON: {
+            return {POLYGON_TIPS, (RATIO_BUCKETS + key.ratio + 1) / 2, StarShape::Core::FULL, key.draw, MeshKey::POLYGON};
+        }
+        case POINT: {
+            return {0, 0, StarShape::Core::FULL, StarShape::Draw::FILL, MeshKey::POINT};
+        }
+        default: {
+            return key;
+        }
+    }
+}
+
+// a single vertex at the center, drawn as a point of the star's size (see instancedVertexSource and SoftwareRasterizer::setup())
+std::unique_ptr<Shape> StarMeshes::pointShape() {
+    std::unique_ptr<Shape> s = std::make_unique<Shape>();
+
+    s->verticesSize = 2;
+    s->vertices     = std::make_unique<float[]>(2);
+    s->vertices[0]  = 0.0f;
+    s->vertices[1]  = 0.0f;
+
+    s->indicesSize = 1;
+    s->indices     = std::make_unique<unsigned[]>(1);
+    s->indices[0]  = 0;
+
+    s->primitive = Shape::Primitive::POINTS;
+
+    return s;
+}
+
+// triangles, line segments, or points drawn per instance
+unsigned StarMeshes::primitives(const Shape& s) {
+    switch (s.primitive) {
+        using enum Shape::Primitive;
+
+        case TRIANGLES: {
+            return s.indicesSize / 3;
+        }
+        case LINE_STRIP: {
+            return s.indicesSize - 1;
+        }
+        default: {
+            return s.indicesSize;
+        }
+    }
+}
+
+// LOD of a star with the given on-screen outer radius (pixels) that used LOD current in the last frame (LODS == none yet)
+// the coarsest LOD whose minimum radius the star reaches, but the star only moves past a threshold once its radius is HYSTERESIS beyond it
+unsigned StarMeshes::selectLOD(double radius, unsigned current) {
+    unsigned target = 0;
+
+    while (target + 1 < LODS && radius < LOD_RADIUS[target]) target++;
+
+    if (current >= LODS) return target;
+
+    while (current < target && radius < LOD_RADIUS[current] * (1.0 - HYSTERESIS)) current++;
+    while (current > target && radius > LOD_RADIUS[current - 1] * (1.0 + HYSTERESIS)) current--;
+
+    return current;
+}
+
+// mesh to draw for a star that uses mesh m, updating its LOD and the counters
+unsigned StarMeshes::selectMesh(unsigned m, double radius, unsigned char& lod) {
+    lod = selectLOD(radius, lod);
+
+    unsigned d = meshes[m].lods[lod];
+
+    lodStats.stars[lod]++;
+    lodStats.primitives[lod] += meshes[d].primitives;
+    lodStats.fullPrimitives += meshes[m].primitives;
+
+    return d;
+}
@@ -0,0 +1,100 @@
+#ifndef STAR_MESHES_H_GUARD
+#define STAR_MESHES_H_GUARD
+
+#include <compare>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "shape.h"
+#include "star_shape.h"
+
+/*
+The CPU geometry of the star meshes and their levels of detail, shared by the instanced renderer (see instanced_renderer.h) and the software rasterizer (see software_rasterizer.h).
+
+Stars share one mesh per class: tips, inner/outer radius ratio (rounded to one of RATIO_BUCKETS buckets), and style.
+A mesh has an outer radius of 1; the outer radius of each star is applied as a scale, so the drawn inner radius is off by at most oRadius / (2 * RATIO_BUCKETS).
+This keeps the number of meshes bounded by the mesh classes instead of growing with the number of stars, and a new star usually does not create any geometry.
+
+Level of detail: stars that are small on screen are drawn with a coarser mesh of their class, selected per frame from their on-screen outer radius.
+    DETAILED: the mesh of the star's class
+    REDUCED:  at most REDUCED_TIPS tips
+    POLYGON:  a polygon (a star with 2 * POLYGON_TIPS corners and equal radii) of the star's average radius, always with a full core
+    POINT:    a point (drawn with the size of the star)
+The LOD meshes are created along with the mesh of each class, and lodStats counts the stars and primitives per LOD of the last selectMesh() pass.
+
+Meshes are reference counted by the stars that use them (and by the meshes whose LOD they are).
+Nothing here depends on GL: a renderer that keeps GL objects per mesh learns which meshes were deleted from release().
+*/
+struct StarMeshes {
+    static constexpr unsigned RATIO_BUCKETS = 64;
+
+    enum LOD {
+        DETAILED,
+        REDUCED,
+        POLYGON,
+        POINT,
+        LODS,
+    };
+
+    static constexpr int REDUCED_TIPS = 8;
+    static constexpr int POLYGON_TIPS = 4;
+
+    // minimum on-screen outer radius (pixels) of each LOD but the last
+    static constexpr double LOD_RADIUS[LODS - 1] = {12.0, 4.0, 1.5};
+    static constexpr double HYSTERESIS           = 0.15;
+
+    struct MeshKey {
+        enum Kind {
+            STAR,
+            POLYGON,
+            POINT,
+        };
+
+        int tips;
+        unsigned ratio; // iRadius / oRadius * RATIO_BUCKETS, rounded
+        StarShape::Core core;
+        StarShape::Draw draw;
+        Kind kind;
+
+        auto operator<=>(const MeshKey&) const = default;
+    };
+
+    struct Mesh {
+        MeshKey key;
+        std::unique_ptr<Shape> shape; // unit outer radius
+        unsigned primitives;          // per instance
+        unsigned references = 0;
+
+        // mesh of each LOD (lods[DETAILED] is this mesh)
+        unsigned lods[LODS];
+    };
+
+    struct LODStats {
+        unsigned stars[LODS]      = {};
+        unsigned primitives[LODS] = {};
+        unsigned fullPrimitives   = 0; // if every star was drawn with its DETAILED mesh
+    };
+
+    std::vector<Mesh> meshes;
+    std::vector<unsigned> freeMeshes;
+    std::map<MeshKey, unsigned> lookup;
+
+    LODStats lodStats;
+
+    bool empty() const;
+
+    unsigned acquire(int, double, double, StarShape::Style);
+    void release(unsigned, std::vector<unsigned>* = nullptr);
+    unsigned acquireMesh(const MeshKey&);
+    void releaseMesh(unsigned, std::vector<unsigned>*);
+
+    unsigned selectMesh(unsigned, double, unsigned char&);
+
+    static MeshKey lodKey(const MeshKey&, unsigned);
+    static std::unique_ptr<Shape> pointShape();
+    static unsigned primitives(const Shape&);
+    static unsigned selectLOD(double, unsigned);
+};
+
+#endif
@@ -0,0 +1,166 @@
+#include <cmath>
+#include <iterator>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "constants.h"
+#include "star_renderer.h"
+
+// must define static class data members in a .cpp file before main otherwise linking fails
+double StarRenderer::uniformPhase = 0.0;
+glm::mat4 StarRenderer::projection;
+
+unsigned StarRenderer::size() const {
+    return mesh.size();
+}
+
+void StarRenderer::reserve(unsigned n) {
+    hueRandom.reserve(n);
+    hueConsistent.reserve(n);
+    mesh.reserve(n);
+    lod.reserve(n);
+}
+
+// star i of stars was just added (the stars have to be added in order)
+void StarRenderer::add(const StarSystem& stars, unsigned i) {
+    hueRandom.push_back(wrapHue(stars.hue[i] - randomPhase));
+    hueConsistent.push_back(wrapHue(-consistentPhase));
+    mesh.push_back(renderer.meshes.acquire(stars.tips[i], stars.iRadius[i], stars.oRadius[i], stars.style[i]));
+    lod.push_back(StarMeshes::LODS);
+}
+
+void StarRenderer::removeLast() {
+    hueRandom.pop_back();
+    hueConsistent.pop_back();
+    renderer.release(mesh.back());
+    mesh.pop_back();
+    lod.pop_back();
+
+    // like the meshes, the GL objects of the SDF renderer are released with the last star
+    if (mesh.empty()) sdf.destroy();
+}
+
+void StarRenderer::clear() {
+    while (!mesh.empty()) removeLast();
+}
+
+// draw pass over all stars: dispatches once on the render and color mode instead of once per star; the draws are submitted to the queue
+void StarRenderer::draw(const StarSystem& stars, RenderQueue& queue, RenderQueue::Layer layer, const RenderQueue::Blend& blend) {
+    using enum Enum::Config::ColorMode;
+    using Enum::Config::RenderMode;
+
+    static constexpr void (StarRenderer::*passes[][4])(const StarSystem&, RenderQueue&, RenderQueue::Layer, const RenderQueue::Blend&) = {
+        {
+            &StarRenderer::draw<RenderMode::MESH, DEFAULT>,
+            &StarRenderer::draw<RenderMode::MESH, RANDOM>,
+            &StarRenderer::draw<RenderMode::MESH, UNIFORM>,
+            &StarRenderer::draw<RenderMode::MESH, CONSISTENT>,
+        },
+        {
+            &StarRenderer::draw<RenderMode::SDF, DEFAULT>,
+            &StarRenderer::draw<RenderMode::SDF, RANDOM>,
+            &StarRenderer::draw<RenderMode::SDF, UNIFORM>,
+            &StarRenderer::draw<RenderMode::SDF, CONSISTENT>,
+        },
+    };
+
+    int render = cfg.renderMode;
+    int mode   = cfg.colorMode;
+
+    if (render < 0 || render >= static_cast<int>(std::size(passes))) render = RenderMode::MESH;
+    if (mode < 0 || mode >= static_cast<int>(std::size(passes[0]))) mode = DEFAULT;
+
+    (this->*passes[render][mode])(stars, queue, layer, blend);
+}
+
+template <Enum::Config::RenderMode RENDER, Enum::Config::ColorMode MODE>
+void StarRenderer::draw(const StarSystem& stars, RenderQueue& queue, RenderQueue::Layer layer, const RenderQueue::Blend& blend) {
+    glm::vec2 palette = advancePalette<MODE>();
+
+    if constexpr (RENDER == Enum::Config::RenderMode::SDF) {
+        // the SDF renderer has no LODs
+        renderer.meshes.lodStats = {};
+
+        SDFRenderer::Instance* instances = sdf.begin(stars.size());
+
+        if (!instances) return;
+
+        for (unsigned i = 0; i < stars.size(); i++) {
+            const StarMeshes::MeshKey& k = renderer.meshes.meshes[mesh[i]].key; // style of the star
+
+            instances[i] = {
+                (float)stars.x[i], (float)stars.y[i], (float)stars.ang[i], (float)stars.oRadius[i],
+                (float)stars.iRadius[i], (float)stars.tips[i], k.core == StarShape::Core::FULL ? 1.0f : 0.0f, k.draw == StarShape::Draw::LINE ? 1.0f : 0.0f,
+                stars.color[i], getHue<MODE>(i)};
+        }
+
+        sdf.end(queue, layer, blend, projection, palette);
+    } else {
+        // the projection maps one unit to one pixel (see prepareProjection()), so oRadius is the on-screen radius
+        renderer.meshes.lodStats = {};
+        lodMesh.resize(stars.size());
+
+        for (unsigned i = 0; i < stars.size(); i++) {
+            lodMesh[i] = renderer.meshes.selectMesh(mesh[i], stars.oRadius[i], lod[i]);
+        }
+
+        InstancedRenderer::Instance* instances = renderer.begin(lodMesh);
+
+        if (!instances) return;
+
+        for (unsigned i = 0; i < stars.size(); i++) {
+            instances[renderer.slots[i]] = {(float)stars.x[i], (float)stars.y[i], (float)stars.ang[i], (float)stars.oRadius[i], stars.color[i], getHue<MODE>(i)};
+        }
+
+        renderer.end(queue, layer, blend, projection, palette);
+    }
+}
+
+// palette uniform of this frame (see RenderQueue::Command); the phase that is drawn is advanced for the next frame, like the per-star color indices used to be
+template <Enum::Config::ColorMode MODE>
+glm::vec2 StarRenderer::advancePalette() {
+    using enum Enum::Config::ColorMode;
+
+    double shift = cfg.colorShiftMult * frameTime / Constants::HUE_STEPS;
+
+    if constexpr (MODE == RANDOM) {
+        glm::vec2 palette = {1.0f, (float)randomPhase};
+        randomPhase       = wrapHue(randomPhase + shift);
+        return palette;
+    } else if constexpr (MODE == UNIFORM) {
+        return {1.0f, (float)uniformPhase};
+    } else if constexpr (MODE == CONSISTENT) {
+        glm::vec2 palette = {1.0f, (float)consistentPhase};
+        consistentPhase   = wrapHue(consistentPhase + shift);
+        return palette;
+    } else {
+        return {0.0f, 0.0f};
+    }
+}
+
+template <Enum::Config::ColorMode MODE>
+float StarRenderer::getHue(unsigned i) const {
+    using enum Enum::Config::ColorMode;
+
+    if constexpr (MODE == RANDOM) return hueRandom[i];
+    else if constexpr (MODE == CONSISTENT) return hueConsistent[i];
+    else return 0.0f;
+}
+
+void StarRenderer::prepareProjection(int width, int height) {
+    projection = glm::translate(glm::mat4(1.0f), glm::vec3(-1.0f, 1.0f, 0.0f)); // before ortho -> NDC
+
+    projection *= glm::ortho(-width / 2.0f,   // left
+                             width / 2.0f,    // right
+                             height / 2.0f,   // bottom
+                             -height / 2.0f); // top
+}
+
+void StarRenderer::updateUniformPhase() {
+    uniformPhase = wrapHue(uniformPhase + cfg.colorShiftMult * frameTime / Constants::HUE_STEPS);
+}
+
+// to [0, 1)
+double StarRenderer::wrapHue(double hue) {
+    return hue - std::floor(hue);
+}
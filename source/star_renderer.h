@@ -0,0 +1,73 @@
+#ifndef STAR_RENDERER_H_GUARD
+#define STAR_RENDERER_H_GUARD
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "config.h"
+#include "instanced_renderer.h"
+#include "render_queue.h"
+#include "sdf_renderer.h"
+#include "star_system.h"
+
+extern struct Config cfg;
+extern double frameTime;
+
+/*
+Draws a StarSystem and keeps the per-star render state (meshes, LODs, hue offsets) in arrays parallel to its arrays.
+
+Stars have to be added and removed in the same order as in their StarSystem: add(stars, i) after star i was added, removeLast() after the last star was removed.
+
+Stars are drawn by an instanced renderer (see instanced_renderer.h) or, in SDF render mode, by an SDF renderer (see sdf_renderer.h), so a StarRenderer must only be used with the context it was filled in.
+
+The RANDOM, UNIFORM, and CONSISTENT color modes cycle through a hue palette (red -> yellow -> green -> cyan -> blue -> magenta -> red) that is evaluated in the vertex shader.
+Every star of a color mode shifts its hue at the same rate, so the hue of star i is its fixed offset plus a phase that only the CPU advances, once per frame:
+    RANDOM:     hueRandom[i] + randomPhase (random initial hue)
+    CONSISTENT: hueConsistent[i] + consistentPhase (initial hue 0, so stars that are added together have the same color)
+    UNIFORM:    uniformPhase (shared by every star and StarRenderer)
+The per-mode phases only advance while their mode is drawn, like the per-star indices into the color table that this replaced.
+Hues and phases are in turns; colorShiftMult is in steps per second, with Constants::HUE_STEPS steps (the size of that color table) per turn.
+*/
+struct StarRenderer {
+    // hue offsets relative to the phase of their color mode (turns)
+    std::vector<float> hueRandom;
+    std::vector<float> hueConsistent;
+
+    std::vector<unsigned> mesh;     // see StarMeshes
+    std::vector<unsigned char> lod; // LOD that the star was drawn with in the last frame (StarMeshes::LODS == none yet)
+    std::vector<unsigned> lodMesh;  // mesh that each star is drawn with this frame
+
+    InstancedRenderer renderer;
+    SDFRenderer sdf;
+
+    double randomPhase     = 0.0;
+    double consistentPhase = 0.0;
+
+    static double uniformPhase;
+    static glm::mat4 projection;
+
+    unsigned size() const;
+    void reserve(unsigned);
+
+    void add(const StarSystem&, unsigned);
+    void removeLast();
+    void clear();
+
+    void draw(const StarSystem&, RenderQueue&, RenderQueue::Layer, const RenderQueue::Blend&);
+
+    // specialized per render mode and color mode
+    template <Enum::Config::RenderMode, Enum::Config::ColorMode>
+    void draw(const StarSystem&, RenderQueue&, RenderQueue::Layer, const RenderQueue::Blend&);
+    template <Enum::Config::ColorMode>
+    glm::vec2 advancePalette();
+    template <Enum::Config::ColorMode>
+    float getHue(unsigned) const;
+
+    static void prepareProjection(int, int);
+
+    static void updateUniformPhase();
+    static double wrapHue(double);
+};
+
+#endif
@@ -1,38 +1,35 @@
 #include "star_shape.h"
 
-StarShape::StarShape(int& tips, double& iRadius, double& oRadius)
+StarShape::StarShape(int tips, double iRadius, double oRadius, Style style)
     : tips(tips), iRadius(iRadius), oRadius(oRadius) {
 
-    const StarStyle& s = cfg.style;
+    {
+        using enum Core;
 
-    if (s.core.full && s.core.empty || !s.core.full && !s.core.empty) {
-        switch (rng.I(0, 1)) {
-            case 0:
+        switch (style.core) {
+            case FULL: {
                 fullCore();
                 break;
-            case 1:
+            }
+            case EMPTY: {
                 emptyCore();
                 break;
+            }
         }
-    } else if (s.core.full) {
-        fullCore();
-    } else {
-        emptyCore();
     }
+    {
+        using enum Draw;
 
-    if (s.draw.fill && s.draw.line || !s.draw.fill && !s.draw.line) {
-        switch (rng.I(0, 1)) {
-            case 0:
+        switch (style.draw) {
+            case FILL: {
                 fillDraw();
                 break;
-            case 1:
+            }
+            case LINE: {
                 lineDraw();
                 break;
+            }
         }
-    } else if (s.draw.fill) {
-        fillDraw();
-    } else {
-        lineDraw();
     }
 }
 
@@ -94,15 +91,6 @@ void StarShape::fullCore() {
             i++;
         }
     }
-
-    // attributes pointer: https://docs.gl/gl4/glVertexAttribPointer
-
-    args_vap.index      = 0;        // index == 0 corresponds to "location" in "layout (location = 0) in vec3 vertex;" in star.vs
-    args_vap.size       = 2;        // we have 2 components per vertex: <x, y>
-    args_vap.type       = GL_FLOAT; // each vertex has floats as the <x, y> types
-    args_vap.normalized = GL_FALSE;
-    args_vap.stride     = args_vap.size * sizeof(float); // to get to the next vertex, add (3 * sizeof(float)) to the index
-    args_vap.pointer    = (void*)0;
 }
 
 void StarShape::emptyCore() {
@@ -145,31 +133,16 @@ void StarShape::emptyCore() {
 
         indices[0] = indices[--c] = d;
     }
-
-    // attributes pointer: https://docs.gl/gl4/glVertexAttribPointer
-
-    args_vap.index      = 0;        // index == 0 corresponds to "location" in "layout (location = 0) in vec3 vertex;" in star.vs
-    args_vap.size       = 2;        // we have 2 components per vertex: <x, y>
-    args_vap.type       = GL_FLOAT; // each vertex has floats as the <x, y> types
-    args_vap.normalized = GL_FALSE;
-    args_vap.stride     = args_vap.size * sizeof(float); // to get to the next vertex, add (3 * sizeof(float)) to the index
-    args_vap.pointer    = (void*)0;
 }
 
 void StarShape::fillDraw() {
     style.draw = Draw::FILL;
 
-    args_de.mode    = GL_TRIANGLES;
-    args_de.count   = tips * 3 * (style.core == Core::FULL ? 2 : 1);
-    args_de.type    = GL_UNSIGNED_INT;
-    args_de.indices = (void*)0;
+    primitive = Primitive::TRIANGLES;
 }
 
 void StarShape::lineDraw() {
     style.draw = Draw::LINE;
 
-    args_de.mode    = GL_LINE_STRIP;
-    args_de.count   = tips * 3 * (style.core == Core::FULL ? 2 : 1);
-    args_de.type    = GL_UNSIGNED_INT;
-    args_de.indices = (void*)0;
+    primitive = Primitive::LINE_STRIP;
 }
\ No newline at end of file
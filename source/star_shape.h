@@ -1,29 +1,29 @@
 #ifndef STAR_SHAPE_H_GUARD
 #define STAR_SHAPE_H_GUARD
 
-#include "rng.h"
-#include "config.h"
 #include "constants.h"
 #include "enums.h"
 #include "shape.h"
+#include "star.h"
 
-extern struct RNG rng;
-extern struct Config cfg;
+/*
+Star geometry: tip triangles around a polygon core that is either filled (FULL) or not (EMPTY), drawn filled or as lines.
 
+Stars do not have their own geometry: StarMeshes builds one shape with an outer radius of 1 per mesh class, which is scaled per star (see star_meshes.h).
+The style is chosen per star when it is generated (see Star::randomStyle()).
+*/
 struct StarShape : Shape {
-    using Core = Enum::Star::Shape::Core;
-    using Draw = Enum::Star::Shape::Draw;
+    using Core  = Star::Core;
+    using Draw  = Star::Draw;
+    using Style = Star::Style;
 
     int tips;
     double iRadius;
     double oRadius;
 
-    struct Style {
-        Core core;
-        Draw draw;
-    } style;
+    Style style;
 
-    StarShape(int&, double&, double&);
+    StarShape(int, double, double, Style);
 
     void fullCore();
     void emptyCore();
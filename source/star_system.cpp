@@ -0,0 +1,132 @@
+#include "star_system.h"
+#include "narrowphase.h"
+
+unsigned StarSystem::size() const {
+    return x.size();
+}
+
+bool StarSystem::empty() const {
+    return x.empty();
+}
+
+void StarSystem::reserve(unsigned n) {
+    x.reserve(n);
+    y.reserve(n);
+    xVel.reserve(n);
+    yVel.reserve(n);
+    ang.reserve(n);
+    angVel.reserve(n);
+    aRadius.reserve(n);
+    oRadius.reserve(n);
+    mass.reserve(n);
+
+    tips.reserve(n);
+    iRadius.reserve(n);
+    density.reserve(n);
+    area.reserve(n);
+    hue.reserve(n);
+    notCollided.reserve(n);
+    color.reserve(n);
+    style.reserve(n);
+}
+
+void StarSystem::add(const Star& s) {
+    x.push_back(s.x);
+    y.push_back(s.y);
+    xVel.push_back(s.xVel);
+    yVel.push_back(s.yVel);
+    ang.push_back(s.ang);
+    angVel.push_back(s.angVel);
+    aRadius.push_back(s.aRadius);
+    oRadius.push_back(s.oRadius);
+    mass.push_back(s.mass);
+
+    tips.push_back(s.tips);
+    iRadius.push_back(s.iRadius);
+    density.push_back(s.density);
+    area.push_back(s.area);
+    hue.push_back(s.hue);
+    notCollided.push_back(true);
+    color.push_back(s.color);
+    style.push_back(s.style);
+}
+
+void StarSystem::removeLast() {
+    x.pop_back();
+    y.pop_back();
+    xVel.pop_back();
+    yVel.pop_back();
+    ang.pop_back();
+    angVel.pop_back();
+    aRadius.pop_back();
+    oRadius.pop_back();
+    mass.pop_back();
+
+    tips.pop_back();
+    iRadius.pop_back();
+    density.pop_back();
+    area.pop_back();
+    hue.pop_back();
+    notCollided.pop_back();
+    color.pop_back();
+    style.pop_back();
+}
+
+void StarSystem::clear() {
+    while (!empty()) removeLast();
+}
+
+IntegrationKernelInfo StarSystem::integration = selectIntegrationKernel();
+
+// update pass over stars [begin, end); runs on the worker threads of the job system
+void StarSystem::update(unsigned begin, unsigned end, const IntegrationParams& p) {
+    integration.kernel(p, {x.data(), y.data(), xVel.data(), yVel.data(), ang.data(), angVel.data(), oRadius.data()}, begin, end);
+}
+
+/*
+This is a circle-based collision response function.
+
+For the purposes of collision handling, each star is treated as a circle where its radius is equal to the average of:
+    inner radius: the distance from the star center point to the nearest point that lies on the edge of the star
+    outer radius: the distance from the star center point to the furthest point that lies on the edge of the star
+
+This is a compromise to minimize these issues:
+    - If we use inner radius as the radius of the colliding circle, then we will have more stars overlapping before colliding (where the overlap is purely visual/graphical).
+    - If we use the outer radius, then we will more frequently see stars that, from visual standpoint, do not appear to touch each other but will still collide due to the star's collision circle extending into the empty space between the star's tips.
+*/
+bool StarSystem::collision(unsigned a, unsigned b) {
+    // defined in narrowphase.h
+    if (!circlesOverlap({x[a], y[a], aRadius[a]}, {x[b], y[b], aRadius[b]})) return false;
+
+    resolveContact(x[a], y[a], x[b], y[b],
+                   xVel[a], yVel[a], xVel[b], yVel[b],
+                   aRadius[a] + aRadius[b], mass[a], mass[b]);
+
+    return true;
+}
+
+// parameters of the update pass for one frame of frameTime seconds in a w x h world
+IntegrationParams StarSystem::integrationParams(const Config& cfg, double frameTime, double w, double h) {
+    IntegrationParams p;
+
+    p.features = 0;
+
+    if (cfg.gravity) p.features |= IntegrationFeature::GRAVITY;
+    if (cfg.accel) p.features |= IntegrationFeature::ACCEL;
+    if (cfg.minSpeed) p.features |= IntegrationFeature::MIN_SPEED;
+    if (cfg.maxSpeed) p.features |= IntegrationFeature::MAX_SPEED;
+
+    p.frameTime   = frameTime;
+    p.gravityStep = cfg.gravityVal * 100 * frameTime;
+
+    if (cfg.accelMult > 1.0) p.accelMult = 1.0 + cfg.accelMult * frameTime;
+    else p.accelMult = 1.0 - (1.0 - cfg.accelMult) * frameTime;
+
+    p.minSpeedLimit = cfg.minSpeedLimit;
+    p.maxSpeedLimit = cfg.maxSpeedLimit;
+
+    p.xMax = w - 1.0;
+    p.yMax = h - 1.0;
+
+    return p;
+}
@@ -0,0 +1,70 @@
+#ifndef STAR_SYSTEM_H_GUARD
+#define STAR_SYSTEM_H_GUARD
+
+#include <vector>
+
+#include "aligned_allocator.h"
+#include "config.h"
+#include "integration.h"
+#include "star.h"
+
+/*
+Structure-of-arrays storage for all stars.
+
+Every property of star i lives at index i of its own array instead of in a separately allocated Star object.
+The per-frame passes (update, collision) therefore stream through contiguous memory and only touch the arrays they actually need.
+
+The hot arrays (read or written by the update and collision passes every frame) are cache line aligned.
+The cold arrays (generation results) are only touched when stars are added or drawn.
+
+This is part of the simulation core, which does not depend on GL or on the globals of the program: the update pass gets its config, frame time, and world size through IntegrationParams.
+Stars are drawn by a StarRenderer (see star_renderer.h), which keeps the per-star render state next to a StarSystem.
+*/
+struct StarSystem {
+    static constexpr std::size_t ALIGNMENT = 64; // bytes; one cache line
+
+    template <typename T>
+    using Array = std::vector<T, AlignedAllocator<T, ALIGNMENT>>;
+
+    // hot
+    Array<double> x;
+    Array<double> y;
+    Array<double> xVel; // pixels per second
+    Array<double> yVel;
+    Array<double> ang;
+    Array<double> angVel; // radians per second
+    Array<double> aRadius;
+    Array<double> oRadius; // needed for the wall reflections
+    Array<double> mass;
+
+    // cold
+    std::vector<int> tips;
+    std::vector<double> iRadius;
+    std::vector<double> density;
+    std::vector<double> area;
+    std::vector<double> hue; // initial hue (turns, see StarRenderer)
+
+    std::vector<char> notCollided;
+
+    std::vector<Color> color;
+    std::vector<Star::Style> style;
+
+    // SIMD kernel used by the update pass (see integration.h)
+    static IntegrationKernelInfo integration;
+
+    unsigned size() const;
+    bool empty() const;
+    void reserve(unsigned);
+
+    void add(const Star&);
+    void removeLast();
+    void clear();
+
+    void update(unsigned, unsigned, const IntegrationParams&);
+
+    bool collision(unsigned, unsigned);
+
+    static IntegrationParams integrationParams(const Config&, double, double, double);
+};
+
+#endif
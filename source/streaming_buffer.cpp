@@ -0,0 +1,111 @@
+#include <cstddef>
+
+#include "streaming_buffer.h"
+
+StreamingBuffer::~StreamingBuffer() {
+    destroy();
+}
+
+// returns memory for the next region (nullptr if bytes == 0); the buffer grows (and gets a new name) if bytes exceeds its capacity
+void* StreamingBuffer::map(unsigned bytes) {
+    if (bytes == 0) return nullptr;
+
+    region = (region + 1) % REGIONS;
+    size   = bytes;
+
+    if (bytes > capacity) create(bytes * 2);
+
+    wait(region);
+
+    if (persistent) return mapped + offset();
+
+    staging.resize(bytes);
+    return staging.data();
+}
+
+void StreamingBuffer::finish() {
+    if (persistent || size == 0) return;
+
+    // clang-format off
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferSubData(GL_ARRAY_BUFFER, offset(), size, staging.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // clang-format on
+}
+
+// must be called after the draw calls that read the current region
+void StreamingBuffer::fence() {
+    if (fences[region]) glDeleteSync(fences[region]);
+
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+// byte offset of the current region
+unsigned StreamingBuffer::offset() const {
+    return region * capacity;
+}
+
+void StreamingBuffer::create(unsigned bytes) {
+    destroy();
+
+    capacity   = bytes;
+    persistent = GLAD_GL_VERSION_4_4;
+    version++;
+
+    glGenBuffers(1, &buffer);
+
+    // clang-format off
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        if (persistent) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+            glBufferStorage(GL_ARRAY_BUFFER, REGIONS * capacity, NULL, flags);
+            mapped = static_cast<char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, REGIONS * capacity, flags));
+
+            if (!mapped) persistent = false;
+        }
+
+        if (!persistent) glBufferData(GL_ARRAY_BUFFER, REGIONS * capacity, NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // clang-format on
+}
+
+void StreamingBuffer::destroy() {
+    if (!buffer) return;
+
+    for (unsigned r = 0; r < REGIONS; r++) {
+        wait(r);
+    }
+
+    if (mapped) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    glDeleteBuffers(1, &buffer);
+
+    buffer     = 0;
+    mapped     = nullptr;
+    persistent = false;
+    capacity   = 0;
+}
+
+// blocks until the GPU is done with region r
+void StreamingBuffer::wait(unsigned r) {
+    if (!fences[r]) return;
+
+    // the first wait flushes the fence so that it is guaranteed to signal eventually
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+
+    while (true) {
+        GLenum status = glClientWaitSync(fences[r], flags, 1000000); // nanoseconds
+
+        if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED || status == GL_WAIT_FAILED) break;
+
+        flags = 0;
+    }
+
+    glDeleteSync(fences[r]);
+    fences[r] = nullptr;
+}
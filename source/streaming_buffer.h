@@ -0,0 +1,46 @@
+#ifndef STREAMING_BUFFER_H_GUARD
+#define STREAMING_BUFFER_H_GUARD
+
+#include <vector>
+
+#include <glad/gl.h>
+
+/*
+Buffer for data that is rewritten every frame (e.g. instance data).
+
+The buffer is split into REGIONS regions that are used round robin: while the GPU may still read the regions of the last frames, the CPU writes the next one.
+A fence is placed after the draw calls that read a region, and the region is only written again once its fence has signaled, which normally already happened.
+
+With OpenGL 4.4 (glBufferStorage), the buffer is mapped once, persistently and coherently, and the data is written straight into it: no driver copies, no map/unmap per frame.
+Otherwise the data is written into CPU memory and uploaded with glBufferSubData() in finish().
+
+Usage per frame: p = map(size); write up to size bytes to p; finish(); draw using offset(); fence().
+The buffer belongs to the context that was current when it was first mapped.
+*/
+struct StreamingBuffer {
+    static constexpr unsigned REGIONS = 3;
+
+    unsigned buffer   = 0;
+    bool persistent   = false;
+    char* mapped      = nullptr;
+    unsigned capacity = 0; // bytes per region
+    unsigned region   = 0; // region being written/drawn this frame
+    unsigned size     = 0; // bytes written to it
+    unsigned version  = 0; // incremented whenever the buffer is created: deleted buffer names may be reused, so the name does not tell whether it changed
+
+    GLsync fences[REGIONS] = {};
+    std::vector<char> staging;
+
+    ~StreamingBuffer();
+
+    void* map(unsigned);
+    void finish();
+    void fence();
+    unsigned offset() const;
+
+    void create(unsigned);
+    void destroy();
+    void wait(unsigned);
+};
+
+#endif
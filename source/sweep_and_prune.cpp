@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <cmath>
+
+#include "sweep_and_prune.h"
+
+// synchronizes the endpoints with the stars and restores their sorted order
+void SweepAndPrune::update(const std::vector<CollisionCircle>& circles) {
+    unsigned n = circles.size();
+
+    // stars are only ever removed from/added to the back of the stars vector, so star indices remain stable
+    if (n < count) std::erase_if(endpoints, [n](const Endpoint& e) { return e.star >= n; });
+
+    unsigned sorted = endpoints.size();
+
+    for (unsigned i = count; i < n; i++) {
+        endpoints.push_back({0.0, i, false});
+        endpoints.push_back({0.0, i, true});
+    }
+
+    count = n;
+
+    for (Endpoint& e : endpoints) {
+        const CollisionCircle& c = circles[e.star];
+        e.value                  = e.max ? c.x + c.r : c.x - c.r;
+    }
+
+    // insertion sort: each endpoint only moves past the few endpoints that it overtook since the last frame
+    for (unsigned i = 1; i < sorted; i++) {
+        Endpoint e = endpoints[i];
+        unsigned j = i;
+
+        for (; j > 0 && e < endpoints[j - 1]; j--) {
+            endpoints[j] = endpoints[j - 1];
+        }
+        endpoints[j] = e;
+    }
+
+    // newly added stars have no previous position to be coherent with, so they are sorted separately and merged in
+    if (sorted < endpoints.size()) {
+        std::sort(endpoints.begin() + sorted, endpoints.end());
+        std::inplace_merge(endpoints.begin(), endpoints.begin() + sorted, endpoints.end());
+    }
+}
+
+void SweepAndPrune::findCandidates(const std::vector<CollisionCircle>& circles, CollisionCandidates& out) {
+    pairs.clear();
+    active.clear();
+    activeSlot.resize(count);
+
+    for (const Endpoint& e : endpoints) {
+        if (!e.max) {
+            const CollisionCircle& a = circles[e.star];
+
+            // every active star overlaps this one along x, so only y remains to be checked
+            for (unsigned b : active) {
+                if (std::abs(a.y - circles[b].y) <= a.r + circles[b].r) pairs.emplace_back(e.star, b);
+            }
+
+            activeSlot[e.star] = active.size();
+            active.push_back(e.star);
+        } else {
+            unsigned slot = activeSlot[e.star];
+            unsigned last = active.back();
+
+            active[slot]     = last;
+            activeSlot[last] = slot;
+            active.pop_back();
+        }
+    }
+
+    out.assign(count, pairs);
+}
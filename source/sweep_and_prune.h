@@ -0,0 +1,45 @@
+#ifndef SWEEP_AND_PRUNE_H_GUARD
+#define SWEEP_AND_PRUNE_H_GUARD
+
+#include <utility>
+#include <vector>
+
+#include "broadphase.h"
+
+/*
+Incremental sweep and prune broadphase along the x axis.
+
+Each star contributes two endpoints (x - r and x + r) to a list that is kept sorted across frames.
+Stars only move (xVel * frameTime) pixels per frame, so the order of the endpoints barely changes from one frame to the next and an insertion sort restores it in close to linear time.
+
+Sweeping the sorted list from left to right while keeping track of the "active" stars (whose min endpoint has been passed but whose max endpoint has not) yields every pair whose x extents overlap.
+Those pairs are then filtered by their y extents before being passed on as candidates.
+*/
+struct SweepAndPrune {
+    struct Endpoint {
+        double value;
+        unsigned star;
+        bool max;
+
+        // on ties, min endpoints come first so that touching stars are reported as overlapping
+        bool operator<(const Endpoint& o) const {
+            return value < o.value || (value == o.value && !max && o.max);
+        }
+    };
+
+    // number of stars currently represented by endpoints
+    unsigned count = 0;
+
+    std::vector<Endpoint> endpoints;
+
+    // stars whose x extents contain the current sweep position; activeSlot maps a star to its position in active
+    std::vector<unsigned> active;
+    std::vector<unsigned> activeSlot;
+
+    std::vector<std::pair<unsigned, unsigned>> pairs;
+
+    void update(const std::vector<CollisionCircle>&);
+    void findCandidates(const std::vector<CollisionCircle>&, CollisionCandidates&);
+};
+
+#endif
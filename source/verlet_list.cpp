@@ -0,0 +1,48 @@
+#include "verlet_list.h"
+
+// true if the lists may be missing pairs that can collide now
+bool VerletList::needsRebuild(const std::vector<CollisionCircle>& circles, double skin) const {
+    if (circles.size() != built.size() || skin != builtSkin) return true;
+
+    double limit = skin / 2.0 * skin / 2.0;
+
+    for (unsigned i = 0; i < circles.size(); i++) {
+        double x = circles[i].x - built[i].x;
+        double y = circles[i].y - built[i].y;
+
+        // stars that changed size (e.g. were regenerated in place) invalidate the lists too
+        if (x * x + y * y > limit || circles[i].r != built[i].r) return true;
+    }
+
+    return false;
+}
+
+// enlarges every circle by half the skin: two enlarged circles overlap if the actual circles are within (skin) of each other
+const std::vector<CollisionCircle>& VerletList::inflate(const std::vector<CollisionCircle>& circles, double skin) {
+    inflated.resize(circles.size());
+
+    for (unsigned i = 0; i < circles.size(); i++) {
+        inflated[i] = {circles[i].x, circles[i].y, circles[i].r + skin / 2.0};
+    }
+
+    return inflated;
+}
+
+// records the state the lists were built from; the lists themselves are filled by the broadphase
+void VerletList::rebuilt(const std::vector<CollisionCircle>& circles, double skin) {
+    built     = circles;
+    builtSkin = skin;
+    rebuilds++;
+}
+
+void VerletList::resetCounters() {
+    frames = rebuilds = 0;
+}
+
+double VerletList::rebuildRate() const {
+    return frames ? static_cast<double>(rebuilds) / frames : 0.0;
+}
+
+double VerletList::averageLength() const {
+    return built.empty() ? 0.0 : static_cast<double>(lists.indices.size()) / built.size();
+}
@@ -0,0 +1,41 @@
+#ifndef VERLET_LIST_H_GUARD
+#define VERLET_LIST_H_GUARD
+
+#include <vector>
+
+#include "broadphase.h"
+
+/*
+Verlet neighbor lists.
+
+Instead of finding candidate pairs from scratch every frame, the broadphase is run with every collision circle enlarged by half of a "skin" distance.
+The resulting lists contain every pair whose circles are within (skin) of each other at build time.
+
+As long as no star has moved more than (skin / 2) since the lists were built, no two stars can have closed a gap larger than (skin), so every pair that can collide is still in the lists and they can be reused as is.
+They are only rebuilt once some star has moved further than that (or stars were added/removed).
+
+A larger skin means fewer rebuilds but longer lists; the counters can be used to tune it for a given scene.
+*/
+struct VerletList {
+    CollisionCandidates lists;
+
+    // circles at the time of the last build
+    std::vector<CollisionCircle> built;
+    double builtSkin = 0.0;
+
+    // enlarged circles that are passed to the broadphase on rebuilds
+    std::vector<CollisionCircle> inflated;
+
+    // counters
+    unsigned frames   = 0;
+    unsigned rebuilds = 0;
+
+    bool needsRebuild(const std::vector<CollisionCircle>&, double) const;
+    const std::vector<CollisionCircle>& inflate(const std::vector<CollisionCircle>&, double);
+    void rebuilt(const std::vector<CollisionCircle>&, double);
+    void resetCounters();
+    double rebuildRate() const;
+    double averageLength() const;
+};
+
+#endif
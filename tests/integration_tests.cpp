@@ -0,0 +1,198 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "constants.h"
+#include "integration.h"
+#include "test.h"
+
+/*
+The SIMD integration kernels against integrateScalar(), for every feature combination:
+    - random stars in batches of 1 to 67 (full vectors and remainders)
+    - wall contacts: stars on, inside, and beyond the walls, moving towards and away from them
+    - zero velocity: blocks that the kernels hand to the reference (forceMove() nudges the star randomly, so only that the star was nudged is checked)
+    - angles around -2 pi and 2 pi, and angular velocities of a full turn or more per frame
+*/
+
+namespace {
+    struct Kernel {
+        SIMDLevel level;
+        IntegrationKernel kernel;
+    };
+
+    const Kernel kernels[] = {
+        {SIMDLevel::SSE2, integrateSSE2},
+        {SIMDLevel::AVX2, integrateAVX2},
+        {SIMDLevel::AVX512, integrateAVX512},
+    };
+
+    struct Stars {
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> xVel;
+        std::vector<double> yVel;
+        std::vector<double> ang;
+        std::vector<double> angVel;
+        std::vector<double> oRadius;
+
+        unsigned size() const { return x.size(); }
+
+        void add(double x, double y, double xVel, double yVel, double ang, double angVel, double oRadius) {
+            this->x.push_back(x);
+            this->y.push_back(y);
+            this->xVel.push_back(xVel);
+            this->yVel.push_back(yVel);
+            this->ang.push_back(ang);
+            this->angVel.push_back(angVel);
+            this->oRadius.push_back(oRadius);
+        }
+
+        void integrate(IntegrationKernel k, const IntegrationParams& p) {
+            k(p, {x.data(), y.data(), xVel.data(), yVel.data(), ang.data(), angVel.data(), oRadius.data()}, 0, size());
+        }
+    };
+
+    IntegrationParams params(unsigned features, double frameTime, double accelMult) {
+        IntegrationParams p;
+
+        p.features      = features;
+        p.frameTime     = frameTime;
+        p.gravityStep   = Constants::GRAVITY * 100 * frameTime;
+        p.accelMult     = accelMult;
+        p.minSpeedLimit = 300.0;
+        p.maxSpeedLimit = 1000.0;
+        p.xMax          = 1919.0;
+        p.yMax          = 1079.0;
+
+        return p;
+    }
+
+    // stars with a zero velocity are only checked for having been nudged if the features call forceMove()
+    void compare(Test& t, const char* name, const Stars& stars, const IntegrationParams& p) {
+        using namespace IntegrationFeature;
+
+        bool nudged = (p.features & (ACCEL | MIN_SPEED)) != 0;
+
+        Stars reference = stars;
+        reference.integrate(integrateScalar, p);
+
+        for (const Kernel& k : kernels) {
+            if (!supported(k.level)) continue;
+
+            Stars s = stars;
+            s.integrate(k.kernel, p);
+
+            for (unsigned i = 0; i < s.size(); i++) {
+                if (nudged && stars.xVel[i] == 0.0 && stars.yVel[i] == 0.0) {
+                    t.check(s.xVel[i] != 0.0 || s.yVel[i] != 0.0, "%s %s features %u: star %u was not nudged", getName(k.level), name, p.features, i);
+                    continue;
+                }
+
+                bool same = sameBits(&s.x[i], &reference.x[i], 1) &&
+                            sameBits(&s.y[i], &reference.y[i], 1) &&
+                            sameBits(&s.xVel[i], &reference.xVel[i], 1) &&
+                            sameBits(&s.yVel[i], &reference.yVel[i], 1) &&
+                            sameBits(&s.ang[i], &reference.ang[i], 1);
+
+                t.check(same, "%s %s features %u: star %u differs from the scalar reference", getName(k.level), name, p.features, i);
+            }
+        }
+    }
+
+    void randomStars(Test& t, std::mt19937_64& mt, unsigned features) {
+        std::uniform_real_distribution<double> U(-1.0, 1.0);
+
+        for (unsigned trial = 0; trial < 64; trial++) {
+            double frameTime = trial % 2 ? 1.0 / 500.0 : 1.0 / 60.0;
+            double accelMult = trial % 4 < 2 ? 1.0 + 2.0 * frameTime : 1.0 - 0.5 * frameTime;
+
+            IntegrationParams p = params(features, frameTime, accelMult);
+
+            Stars s;
+            unsigned n = 1 + mt() % 67;
+
+            for (unsigned i = 0; i < n; i++) {
+                double r = 1.0 + (U(mt) + 1.0) * 40.0;
+
+                s.add((U(mt) + 1.0) / 2.0 * p.xMax, (U(mt) + 1.0) / 2.0 * p.yMax,
+                      U(mt) * (mt() % 3 ? 500.0 : 5000.0), U(mt) * (mt() % 3 ? 500.0 : 5000.0),
+                      U(mt) * Constants::TWO_PI, U(mt) * 20.0, r);
+            }
+
+            compare(t, "random", s, p);
+        }
+    }
+
+    void wallContacts(Test& t, unsigned features) {
+        IntegrationParams p = params(features, 1.0 / 60.0, 1.0);
+
+        const double r = 20.0;
+
+        // positions relative to each wall: beyond, on, just inside, and clear of it
+        const double offsets[] = {-30.0, -r, -1.0, 0.0, 0.5, r - 1.0, r, r + 0.25, 100.0};
+        const double speeds[]  = {-600.0, -5.0, 5.0, 600.0};
+
+        Stars s;
+
+        for (double o : offsets) {
+            for (double v : speeds) {
+                s.add(o, 500.0, v, 0.0, 0.0, 1.0, r);          // left
+                s.add(p.xMax - o, 500.0, v, 0.0, 0.0, 1.0, r); // right
+                s.add(900.0, o, 0.0, v, 0.0, 1.0, r);          // top
+                s.add(900.0, p.yMax - o, 0.0, v, 0.0, 1.0, r); // bottom
+                s.add(o, p.yMax - o, v, -v, 0.0, 1.0, r);      // corner
+            }
+        }
+
+        compare(t, "walls", s, p);
+    }
+
+    void zeroVelocity(Test& t, unsigned features) {
+        IntegrationParams p = params(features, 1.0 / 60.0, 1.0 + 2.0 / 60.0);
+
+        // one star without velocity per block of each vector width, at different lanes
+        Stars s;
+
+        for (unsigned i = 0; i < 40; i++) {
+            bool still = i % 9 == 0;
+            s.add(100.0 + i * 30.0, 500.0, still ? 0.0 : 50.0 + i, still ? 0.0 : -20.0, 0.5, 1.0, 10.0);
+        }
+
+        compare(t, "zero velocity", s, p);
+    }
+
+    void angles(Test& t, unsigned features) {
+        IntegrationParams p = params(features, 1.0 / 60.0, 1.0);
+
+        const double turn = Constants::TWO_PI;
+
+        const double angs[]    = {-turn, std::nextafter(-turn, 0.0), std::nextafter(-turn, -4.0 * turn), -turn + 1e-9, turn - 1e-9,
+                                  std::nextafter(turn, 0.0), turn, std::nextafter(turn, 4.0 * turn), 0.0, -0.0};
+        const double angVels[] = {0.0, 1e-3, -1e-3, 60.0, -60.0, turn * 60.0, -turn * 60.0, turn * 61.0, -turn * 200.0};
+
+        Stars s;
+
+        for (double a : angs) {
+            for (double v : angVels) {
+                s.add(900.0, 500.0, 40.0, -30.0, a, v, 10.0);
+            }
+        }
+
+        // lands exactly on a full turn in the frame
+        s.add(900.0, 500.0, 40.0, -30.0, -60.0 * p.frameTime - turn, 60.0, 10.0);
+        s.add(900.0, 500.0, 40.0, -30.0, turn - 60.0 * p.frameTime, 60.0, 10.0);
+
+        compare(t, "angles", s, p);
+    }
+} // namespace
+
+void testIntegration(Test& t) {
+    std::mt19937_64 mt(1);
+
+    for (unsigned features = 0; features < IntegrationFeature::COMBINATIONS; features++) {
+        randomStars(t, mt, features);
+        wallContacts(t, features);
+        zeroVelocity(t, features);
+        angles(t, features);
+    }
+}
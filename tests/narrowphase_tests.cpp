@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "narrowphase.h"
+#include "test.h"
+
+/*
+The SIMD narrowphase kernels against overlapScalar() and resolveContactsScalar():
+    - overlap masks of batches of 1 to OVERLAP_BATCH pairs, given by indices or as a contiguous range, including exactly touching and coincident circles
+    - contact response of random disjoint contacts, some of them with coincident centers
+    - a fixed contact with exactly coincident centers: the stars are pushed apart along the x axis by half the radii each, without NaNs
+*/
+
+namespace {
+    struct Kernels {
+        SIMDLevel level;
+        OverlapKernel overlap;
+        ContactKernel resolve;
+    };
+
+    const Kernels kernels[] = {
+        {SIMDLevel::SSE2, overlapSSE2, resolveContactsSSE2},
+        {SIMDLevel::AVX2, overlapAVX2, resolveContactsAVX2},
+        {SIMDLevel::AVX512, overlapAVX512, resolveContactsAVX512},
+    };
+
+    struct Stars {
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> xVel;
+        std::vector<double> yVel;
+        std::vector<double> radius;
+        std::vector<double> mass;
+
+        unsigned size() const { return x.size(); }
+
+        void add(double x, double y, double xVel, double yVel, double radius, double mass) {
+            this->x.push_back(x);
+            this->y.push_back(y);
+            this->xVel.push_back(xVel);
+            this->yVel.push_back(yVel);
+            this->radius.push_back(radius);
+            this->mass.push_back(mass);
+        }
+
+        void resolve(ContactKernel k, const std::vector<std::pair<unsigned, unsigned>>& contacts) {
+            k({x.data(), y.data(), xVel.data(), yVel.data(), radius.data(), mass.data()}, contacts.data(), contacts.size());
+        }
+
+        bool operator==(const Stars& s) const {
+            unsigned n = size();
+
+            return sameBits(x.data(), s.x.data(), n) &&
+                   sameBits(y.data(), s.y.data(), n) &&
+                   sameBits(xVel.data(), s.xVel.data(), n) &&
+                   sameBits(yVel.data(), s.yVel.data(), n);
+        }
+    };
+
+    void overlapMasks(Test& t, std::mt19937_64& mt) {
+        std::uniform_real_distribution<double> U(0.0, 1.0);
+
+        for (unsigned trial = 0; trial < 200; trial++) {
+            unsigned n = 2 + mt() % 100;
+
+            std::vector<CollisionCircle> c(n);
+
+            for (CollisionCircle& circle : c) {
+                circle = {U(mt) * 200.0, U(mt) * 200.0, 1.0 + U(mt) * 20.0};
+            }
+
+            // exactly touching (on the boundary of le(), exact in doubles) and coincident
+            c[0] = {50.0, 50.0, 10.0};
+            c[1] = {75.0, 50.0, 15.0};
+            if (n > 2) c[2] = {50.0, 50.0, 3.0};
+
+            for (unsigned a = 0; a < n; a++) {
+                std::vector<unsigned> b;
+
+                for (unsigned i = 0; i < n; i++) {
+                    if (i != a && mt() % 2) b.push_back(i);
+                }
+
+                for (unsigned k = 0; k < b.size(); k += NarrowphaseKernels::OVERLAP_BATCH) {
+                    unsigned count = std::min<unsigned>(NarrowphaseKernels::OVERLAP_BATCH, b.size() - k);
+                    std::uint32_t reference = overlapScalar(c[a], c.data(), b.data() + k, 0, count);
+
+                    for (const Kernels& v : kernels) {
+                        if (!supported(v.level)) continue;
+
+                        t.check(v.overlap(c[a], c.data(), b.data() + k, 0, count) == reference,
+                                "%s overlap: indexed batch of %u pairs of star %u differs from the scalar reference", getName(v.level), count, a);
+                    }
+                }
+
+                for (unsigned first = a + 1; first < n; first += NarrowphaseKernels::OVERLAP_BATCH) {
+                    unsigned count = std::min(NarrowphaseKernels::OVERLAP_BATCH, n - first);
+                    std::uint32_t reference = overlapScalar(c[a], c.data(), nullptr, first, count);
+
+                    for (const Kernels& v : kernels) {
+                        if (!supported(v.level)) continue;
+
+                        t.check(v.overlap(c[a], c.data(), nullptr, first, count) == reference,
+                                "%s overlap: range [%u, %u) of star %u differs from the scalar reference", getName(v.level), first, first + count, a);
+                    }
+                }
+            }
+
+            t.check(overlapScalar(c[0], c.data(), nullptr, 1, 1) == 1, "touching circles do not overlap");
+        }
+    }
+
+    void randomContacts(Test& t, std::mt19937_64& mt) {
+        std::uniform_real_distribution<double> U(0.0, 1.0);
+
+        for (unsigned trial = 0; trial < 500; trial++) {
+            unsigned n = 2 + mt() % 200;
+
+            Stars s;
+
+            for (unsigned i = 0; i < n; i++) {
+                s.add(U(mt) * 200.0, U(mt) * 200.0, U(mt) * 200.0 - 100.0, U(mt) * 200.0 - 100.0, 1.0 + U(mt) * 20.0, 1.0 + U(mt) * 100.0);
+            }
+
+            std::vector<unsigned> order(n);
+            std::iota(order.begin(), order.end(), 0);
+            std::shuffle(order.begin(), order.end(), mt);
+
+            std::vector<std::pair<unsigned, unsigned>> contacts;
+
+            for (unsigned i = 0; i + 1 < n; i += 2) {
+                contacts.push_back({order[i], order[i + 1]});
+            }
+
+            // coincident centers in some lanes
+            for (unsigned i = trial % 3; i < contacts.size(); i += 5) {
+                auto [a, b] = contacts[i];
+                s.x[b]      = s.x[a];
+                s.y[b]      = s.y[a];
+            }
+
+            Stars reference = s;
+            reference.resolve(resolveContactsScalar, contacts);
+
+            for (const Kernels& v : kernels) {
+                if (!supported(v.level)) continue;
+
+                Stars simd = s;
+                simd.resolve(v.resolve, contacts);
+
+                t.check(simd == reference, "%s resolve: %u contacts differ from the scalar reference", getName(v.level), unsigned(contacts.size()));
+            }
+        }
+    }
+
+    void coincidentCenters(Test& t) {
+        // one full vector of the widest kernel plus a remainder, so that both the SIMD lanes and the scalar tail see the case
+        static constexpr unsigned CONTACTS = 9;
+
+        Stars s;
+
+        for (unsigned i = 0; i < CONTACTS; i++) {
+            s.add(100.0, 50.0, 30.0, -10.0, 4.0, 2.0);
+            s.add(100.0, 50.0, -20.0, 5.0, 6.0, 3.0);
+        }
+
+        // radii 0: overlapCorrection() cannot separate them, so the velocities have to be left unchanged
+        s.add(10.0, 10.0, 1.0, 2.0, 0.0, 1.0);
+        s.add(10.0, 10.0, 3.0, 4.0, 0.0, 1.0);
+
+        std::vector<std::pair<unsigned, unsigned>> contacts;
+
+        for (unsigned i = 0; i < CONTACTS + 1; i++) {
+            contacts.push_back({2 * i, 2 * i + 1});
+        }
+
+        Stars reference = s;
+        reference.resolve(resolveContactsScalar, contacts);
+
+        for (unsigned i = 0; i < reference.size(); i++) {
+            bool finite = std::isfinite(reference.x[i]) && std::isfinite(reference.y[i]) && std::isfinite(reference.xVel[i]) && std::isfinite(reference.yVel[i]);
+            t.check(finite, "coincident centers: star %u is not finite", i);
+        }
+
+        for (unsigned i = 0; i < CONTACTS; i++) {
+            unsigned a = 2 * i;
+            unsigned b = 2 * i + 1;
+
+            t.check(reference.x[a] == 105.0 && reference.x[b] == 95.0 && reference.y[a] == 50.0 && reference.y[b] == 50.0,
+                    "coincident centers: contact %u is not separated along the x axis", i);
+        }
+
+        unsigned a = 2 * CONTACTS;
+        unsigned b = a + 1;
+
+        t.check(reference.x[a] == 10.0 && reference.xVel[a] == 1.0 && reference.yVel[a] == 2.0 && reference.xVel[b] == 3.0 && reference.yVel[b] == 4.0,
+                "coincident centers: stars without radius were moved or changed velocity");
+
+        for (const Kernels& v : kernels) {
+            if (!supported(v.level)) continue;
+
+            Stars simd = s;
+            simd.resolve(v.resolve, contacts);
+
+            t.check(simd == reference, "%s resolve: coincident centers differ from the scalar reference", getName(v.level));
+        }
+    }
+} // namespace
+
+void testNarrowphase(Test& t) {
+    std::mt19937_64 mt(2);
+
+    overlapMasks(t, mt);
+    randomContacts(t, mt);
+    coincidentCenters(t);
+}
@@ -0,0 +1,37 @@
+#ifndef TEST_H_GUARD
+#define TEST_H_GUARD
+
+#include <cstring>
+
+#include "simd.h"
+
+/*
+Tests of the simulation core (stars_tests, run by ctest; see CMakeLists.txt).
+
+There is no test framework: a suite is a function that records its checks in a Test and the program fails if any check of a suite that was run failed.
+The SIMD kernels are compared bit for bit against their scalar references, for every instruction set that the CPU running the tests supports (see simd.h).
+*/
+struct Test {
+    static constexpr unsigned MAX_REPORTED = 10; // failures printed per suite
+
+    const char* suite;
+
+    unsigned checks   = 0;
+    unsigned failures = 0;
+
+    // records one check; the first failures are reported with a printf-style description
+    void check(bool, const char*, ...);
+};
+
+void testIntegration(Test&);
+void testNarrowphase(Test&);
+
+inline bool sameBits(const double* a, const double* b, unsigned n) {
+    return memcmp(a, b, n * sizeof(double)) == 0;
+}
+
+inline bool supported(SIMDLevel level) {
+    return detectSIMDLevel() >= level;
+}
+
+#endif
@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+#include "test.h"
+
+/*
+Runs the suites named on the command line (all of them without arguments): stars_tests [integration] [narrowphase]
+Exits with 1 if a check failed or a suite does not exist.
+*/
+
+struct Suite {
+    const char* name;
+    void (*run)(Test&);
+};
+
+static const Suite suites[] = {
+    {"integration", testIntegration},
+    {"narrowphase", testNarrowphase},
+};
+
+void Test::check(bool ok, const char* format, ...) {
+    checks++;
+
+    if (ok) return;
+
+    if (failures++ < MAX_REPORTED) {
+        printf("%s: FAILED: ", suite);
+
+        va_list args;
+        va_start(args, format);
+        vprintf(format, args);
+        va_end(args);
+
+        printf("\n");
+    }
+}
+
+static bool run(const Suite& s) {
+    Test t{s.name};
+    s.run(t);
+
+    printf("%s: %u checks, %u failed\n", s.name, t.checks, t.failures);
+
+    return t.failures == 0;
+}
+
+int main(int argc, char** argv) {
+    printf("stars_tests: SIMD level %s\n", getName(detectSIMDLevel()));
+
+    bool passed = true;
+
+    if (argc < 2) {
+        for (const Suite& s : suites) {
+            passed &= run(s);
+        }
+    }
+
+    for (int i = 1; i < argc; i++) {
+        const Suite* s = std::find_if(std::begin(suites), std::end(suites), [&](const Suite& s) { return strcmp(s.name, argv[i]) == 0; });
+
+        if (s == std::end(suites)) {
+            printf("stars_tests: unknown suite \"%s\"\n", argv[i]);
+            passed = false;
+        } else {
+            passed &= run(*s);
+        }
+    }
+
+    return passed ? 0 : 1;
+}